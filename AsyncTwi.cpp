@@ -0,0 +1,206 @@
+#include "AsyncTwi.h"
+#include "DisplayTransfer.h" // gDisplayStats
+
+#if DISPLAY_ASYNC
+
+static_assert((TWI_QUEUE_SIZE & (TWI_QUEUE_SIZE - 1)) == 0 && TWI_QUEUE_SIZE <= 256, "TWI_QUEUE_SIZE must be a power of 2, at most 256");
+#define TWI_QUEUE_MASK (TWI_QUEUE_SIZE - 1)
+
+static uint8_t sQueue[TWI_QUEUE_SIZE];
+static volatile uint8_t sHead;      // next byte to send
+static volatile uint8_t sCommitted; // end of the last complete transaction
+static uint8_t sTail;               // next free byte
+static uint8_t sLength;             // position of the length of the transaction being queued
+static volatile bool sBusy;
+static uint8_t sAddress;
+
+// Bytes left in the transaction being sent
+static uint8_t sRemaining;
+
+static inline uint8_t QueueFree() { return TWI_QUEUE_MASK - ((sTail - sHead) & TWI_QUEUE_MASK); }
+static void Send();
+
+static inline uint8_t Pop()
+{
+    const uint8_t value = sQueue[sHead];
+    sHead = (sHead + 1) & TWI_QUEUE_MASK;
+    return value;
+}
+
+#ifdef __AVR__
+
+#include <util/twi.h>
+
+#define TWI_SEND (_BV(TWINT) | _BV(TWEN) | _BV(TWIE))
+#define TWI_START (TWI_SEND | _BV(TWSTA))
+#define TWI_STOP (_BV(TWINT) | _BV(TWEN) | _BV(TWSTO))
+
+static void Begin()
+{
+    // SDA and SCL pull-ups, prescaler 1
+    digitalWrite(SDA, HIGH);
+    digitalWrite(SCL, HIGH);
+    TWSR = 0;
+    TWBR = (F_CPU / TWI_CLOCK - 16) / 2;
+    TWCR = _BV(TWEN);
+}
+
+// Start sending the queue (interrupts are off)
+static void Send()
+{
+    // The STOP of the previous transaction must be on the bus before a new START
+    while (TWCR & _BV(TWSTO))
+        ;
+    sBusy = true;
+    TWCR = TWI_START;
+}
+
+ISR(TWI_vect)
+{
+    switch (TW_STATUS)
+    {
+    case TW_START:
+    case TW_REP_START:
+        sRemaining = Pop();
+        TWDR = sAddress;
+        TWCR = TWI_SEND;
+        break;
+    case TW_MT_SLA_ACK:
+    case TW_MT_DATA_ACK:
+        if (sRemaining > 0)
+        {
+            sRemaining--;
+            TWDR = Pop();
+            TWCR = TWI_SEND;
+        }
+        // Next transaction right away (repeated start), or release the bus
+        else if (sHead != sCommitted)
+            TWCR = TWI_START;
+        else
+        {
+            TWCR = TWI_STOP;
+            sBusy = false;
+        }
+        break;
+    // Not acknowledged or arbitration lost: drop the rest of the transaction
+    default:
+        sHead = (sHead + sRemaining) & TWI_QUEUE_MASK;
+        sRemaining = 0;
+        gDisplayStats.busErrors++;
+        if (sHead != sCommitted)
+            TWCR = TWI_STOP | _BV(TWSTA) | _BV(TWIE);
+        else
+        {
+            TWCR = TWI_STOP;
+            sBusy = false;
+        }
+        break;
+    }
+}
+
+static inline void Drain() {}
+// The interrupt makes room in the queue
+static inline void Wait() {}
+
+#else
+
+// Host stand-in: every byte (and its ACK bit) takes 9 clocks on the bus
+#define TWI_BYTE_CLOCKS 9
+
+static unsigned long sStart; // micros() when the bus started sending the queue
+static unsigned long sBytes; // bytes sent on the bus since then
+
+static void Begin() {}
+static void Send()
+{
+    sBusy = true;
+    sStart = micros();
+    sBytes = 0;
+}
+
+/*
+    Remove from the queue what the bus has sent since the last call: every transaction is its
+    address byte (sent while the length of the transaction is taken out of the queue), then its
+    data bytes. START and STOP conditions are not modelled.
+*/
+static void Drain()
+{
+    const unsigned long sent = (micros() - sStart) * (TWI_CLOCK / 1000) / (TWI_BYTE_CLOCKS * 1000);
+    while (sBusy && sBytes < sent)
+    {
+        sBytes++;
+        if (sRemaining == 0)
+            sRemaining = Pop();
+        else
+        {
+            Pop();
+            sRemaining--;
+        }
+        if (sRemaining == 0 && sHead == sCommitted)
+            sBusy = false;
+    }
+}
+
+// Time goes by while waiting for the bus
+static inline void Wait()
+{
+    delayMicroseconds(1);
+    Drain();
+}
+
+#endif
+
+bool AsyncTwiBusy()
+{
+    Drain();
+    return sBusy;
+}
+
+// Queue one byte, waiting for room if the queue is full
+static void Push(uint8_t value)
+{
+    while (QueueFree() == 0)
+        Wait();
+    sQueue[sTail] = value;
+    sTail = (sTail + 1) & TWI_QUEUE_MASK;
+}
+
+uint8_t AsyncTwiByteCb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+    switch (msg)
+    {
+    case U8X8_MSG_BYTE_SEND:
+    {
+        const uint8_t *data = static_cast<const uint8_t *>(arg_ptr);
+        while (arg_int--)
+        {
+            Push(*data++);
+            sQueue[sLength]++;
+        }
+        break;
+    }
+    case U8X8_MSG_BYTE_INIT:
+        sAddress = u8x8_GetI2CAddress(u8x8);
+        Begin();
+        break;
+    case U8X8_MSG_BYTE_START_TRANSFER:
+        sLength = sTail;
+        Push(0);
+        break;
+    case U8X8_MSG_BYTE_END_TRANSFER:
+    {
+        // Hand the transaction to the interrupt
+        noInterrupts();
+        sCommitted = sTail;
+        if (!sBusy)
+            Send();
+        interrupts();
+        break;
+    }
+    default:
+        break;
+    }
+    return 1;
+}
+
+#endif
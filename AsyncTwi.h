@@ -0,0 +1,50 @@
+#ifndef ASYNC_TWI_H
+#define ASYNC_TWI_H
+
+/*
+    Interrupt-driven I2C transport for the display (built with DISPLAY_ASYNC set to 1).
+    The u8g2 HW_I2C transport (Wire) keeps the CPU in nextPage() while every byte of the page is
+    clocked out. Here the bytes of each I2C transaction are copied into a queue and sent by the
+    TWI interrupt: nextPage() returns as soon as the page is queued, and the next page is drawn
+    in its page buffer while the queue (the second page buffer) goes out on the bus. The CPU
+    only waits when the queue is full (see DisplayStats::waitUs).
+    Host builds have no TWI: the queue is emptied at the speed of the bus (TWI_CLOCK) measured
+    with micros(), an address byte then the data bytes per transaction. test/AsyncTwiTest.cpp
+    measures the overlap on it, for a full screen frame (26.1 ms on the bus): the drawing of
+    the pages after the first one overlaps the bus, up to the 2.9 ms of bus time the queue
+    holds. With 1 ms of drawing per page 3 ms overlap, with 4 ms and more 8.6 ms.
+    The interrupt itself has not been run on an UNO.
+
+    Queue: | length | bytes... | per transaction, queued when complete (u8x8 transactions are
+    small, the SSD1306 I2C driver splits data in chunks of a few dozen bytes).
+
+    The Wire library must not be built (it owns the TWI interrupt): build with the compiler flag
+    -DU8X8_NO_HW_I2C so that u8g2 does not pull it in.
+*/
+
+#include <U8g2lib.h>
+
+#include "Util.h"
+
+// Queue size (power of 2)
+#define TWI_QUEUE_SIZE 128
+// I2C clock (Hz), the SSD1306 supports fast mode
+#define TWI_CLOCK 400000UL
+
+// u8x8 byte callback (transport) of the asynchronous display
+uint8_t AsyncTwiByteCb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
+
+// True while queued bytes are still being sent
+bool AsyncTwiBusy();
+
+// SSD1306 128x64 with 2 tile rows pages (like U8G2_SSD1306_128X64_NONAME_2_HW_I2C) on the asynchronous transport
+class U8G2_SSD1306_128X64_NONAME_2_ASYNC_I2C : public U8G2
+{
+public:
+    U8G2_SSD1306_128X64_NONAME_2_ASYNC_I2C(const u8g2_cb_t *rotation)
+    {
+        u8g2_Setup_ssd1306_i2c_128x64_noname_2(&u8g2, rotation, AsyncTwiByteCb, u8x8_gpio_and_delay_arduino);
+    }
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "DisplayList.h"
+#include "Game.h"
+
+DisplayList gDisplayList;
+
+int DrawCommand::Top() const
+{
+    switch (op)
+    {
+    case DrawOp::CIRCLE:
+        return y - w;
+    case DrawOp::NUMBER:
+        return y - TEXT_ASCENT;
+    default:
+        return y;
+    }
+}
+
+int DrawCommand::Bottom() const
+{
+    switch (op)
+    {
+    case DrawOp::CIRCLE:
+        return y + w + 1;
+    case DrawOp::NUMBER:
+        return y + TEXT_DESCENT;
+    default:
+        return y + h;
+    }
+}
+
+DisplayList::DisplayList() : stats(), mPending(), mCount(0), mImmediate(false) {}
+
+/*
+    The commands past the list go through mPending, where the next pixels can still extend
+    them; a command is complete when the next one is added. Recording again, every command goes
+    through mPending (the list is not touched), so the commands are merged the same way and
+    numbered the same: the ones numbered past the list are drawn.
+*/
+void DisplayList::Add(DrawOp op, uint8_t x, uint8_t y, uint8_t w, uint8_t h)
+{
+    DrawPending();
+    const DrawCommand command = {op, x, y, w, h};
+    if (!mImmediate && mCount < DISPLAY_LIST_SIZE)
+        mCommands[mCount] = command;
+    else
+        mPending = command;
+    mCount++;
+}
+
+DrawCommand *DisplayList::Last()
+{
+    if (mCount == 0)
+        return NULL;
+    return !mImmediate && mCount <= DISPLAY_LIST_SIZE ? &mCommands[mCount - 1] : &mPending;
+}
+
+// Draw the last command if it's one that did not fit the list
+void DisplayList::DrawPending()
+{
+    if (mImmediate && mCount > DISPLAY_LIST_SIZE)
+        DrawOnPage(mPending);
+}
+
+void DisplayList::Box(uint8_t x, uint8_t y, uint8_t w, uint8_t h) { Add(DrawOp::BOX, x, y, w, h); }
+void DisplayList::Frame(uint8_t x, uint8_t y, uint8_t w, uint8_t h) { Add(DrawOp::FRAME, x, y, w, h); }
+void DisplayList::Circle(uint8_t x, uint8_t y, uint8_t radius) { Add(DrawOp::CIRCLE, x, y, radius, 0); }
+void DisplayList::Number(uint8_t x, uint8_t y, uint8_t value) { Add(DrawOp::NUMBER, x, y, value, 0); }
+
+void DisplayList::Pixel(uint8_t x, uint8_t y)
+{
+    // Extend the previous line (or pixel) when the new pixel continues it at either end
+    if (DrawCommand *last = Last())
+    {
+        if (last->op == DrawOp::BOX && last->h == 1 && last->y == y && (x == last->x + last->w || x + 1 == last->x))
+        {
+            last->x = min(last->x, x);
+            last->w++;
+            return;
+        }
+        if (last->op == DrawOp::BOX && last->w == 1 && last->x == x && (y == last->y + last->h || y + 1 == last->y))
+        {
+            last->y = min(last->y, y);
+            last->h++;
+            return;
+        }
+    }
+    Box(x, y, 1, 1);
+}
+
+// Draw a command if it covers rows of the page buffer
+void DisplayList::DrawOnPage(const DrawCommand &command)
+{
+    const int top = u8g2.getBufferCurrTileRow() * 8;
+    const int bottom = top + u8g2.getBufferTileHeight() * 8;
+    if (command.Bottom() > top && command.Top() < bottom)
+        Execute(command);
+}
+
+void DisplayList::Execute(const DrawCommand &command)
+{
+    stats.last.drawCalls++;
+    switch (command.op)
+    {
+    case DrawOp::BOX:
+        u8g2.drawBox(command.x, command.y, command.w, command.h);
+        break;
+    case DrawOp::FRAME:
+        u8g2.drawFrame(command.x, command.y, command.w, command.h);
+        break;
+    case DrawOp::CIRCLE:
+        u8g2.drawCircle(command.x, command.y, command.w, U8G2_DRAW_ALL);
+        break;
+    case DrawOp::NUMBER:
+        u8g2.setCursor(command.x, command.y);
+        u8g2.print(command.w);
+        break;
+    }
+}
+
+void DisplayList::EndFrame(uint16_t count)
+{
+    stats.last.commands = min(count, 255);
+    stats.frames++;
+    if (count > DISPLAY_LIST_SIZE)
+        stats.immediateFrames++;
+    stats.worst.commands = max(stats.worst.commands, stats.last.commands);
+    stats.worst.drawCalls = max(stats.worst.drawCalls, stats.last.drawCalls);
+}
+
+// Send the page just drawn (see GamePad.ino)
+uint8_t DisplayList::NextPage() { return ::NextPage(); }
+
+void DisplayList::BeginFrame()
+{
+    // Numbers are printed with the text font, whatever screen was drawn before
+    u8g2.setFont(FONT_TEXT);
+    u8g2.firstPage();
+}
+
+// Draw the first `count` commands of the list on the current page
+void DisplayList::ReplayPage(uint8_t count)
+{
+    for (uint8_t i = 0; i < count; ++i)
+        DrawOnPage(mCommands[i]);
+}
@@ -0,0 +1,125 @@
+#ifndef DISPLAY_LIST_H
+#define DISPLAY_LIST_H
+
+/*
+    Display list: u8g2 page mode needs the whole frame to be drawn once per page, so instead of
+    walking the game state for every page, games record their primitives once per frame in a
+    fixed-size array, which is then replayed for every page skipping the commands off-page.
+    Collinear pixels are merged into a single line (e.g. a whole straight piece of the snake).
+    If a frame does not fit, the commands recorded are still replayed for every page, and the
+    frame is recorded again for each page only to draw the commands that did not fit (the
+    recorded ones are counted and skipped, the others are drawn right away if they are on-page).
+    The cost of every frame is measured (FrameStats), so the host can check it against a budget
+    (the pixels set are only counted by the host tests, in the display stand-in).
+*/
+
+#include "Arduino.h"
+
+/*
+    Maximum number of commands in a frame (5 bytes each). The worst frame of the shipped Snake
+    levels without the snake is 9 commands (walls, obstacles in sight, the score and the apple,
+    over every camera position, see FrameTest): 23 straight pieces of the snake fit in sight.
+    A frame with more is still drawn without redrawing the commands that fit (see above).
+*/
+#define DISPLAY_LIST_SIZE 32
+
+// Text height used for culling (above and below the baseline), large enough for every font
+#define TEXT_ASCENT 16
+#define TEXT_DESCENT 4
+
+enum struct DrawOp : uint8_t
+{
+    BOX,    // x, y, w, h
+    FRAME,  // x, y, w, h
+    CIRCLE, // centre x, centre y, w = radius
+    NUMBER  // cursor x, baseline y, w = value printed with the current font
+};
+
+struct DrawCommand
+{
+    DrawOp op;
+    uint8_t x, y, w, h;
+
+    // Rows covered by the command: [Top(), Bottom())
+    int Top() const;
+    int Bottom() const;
+};
+
+struct FrameCost
+{
+    uint8_t commands;   // commands of the frame (more than DISPLAY_LIST_SIZE if it did not fit, at most 255)
+    uint16_t drawCalls; // u8g2 drawing calls, over all the pages
+};
+
+struct FrameStats
+{
+    uint16_t frames;          // frames drawn
+    uint16_t immediateFrames; // frames that did not fit the list
+    FrameCost last;           // cost of the last frame
+    FrameCost worst;          // worst cost of every field since the last reset
+};
+
+class DisplayList
+{
+public:
+    DisplayList();
+
+    void Box(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+    void Frame(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+    inline void HLine(uint8_t x, uint8_t y, uint8_t w) { Box(x, y, w, 1); }
+    inline void VLine(uint8_t x, uint8_t y, uint8_t h) { Box(x, y, 1, h); }
+    void Pixel(uint8_t x, uint8_t y);
+    void Circle(uint8_t x, uint8_t y, uint8_t radius);
+    void Number(uint8_t x, uint8_t y, uint8_t value);
+
+    // Draw a frame: `record(list)` must issue all the drawing commands of the frame
+    template <class F>
+    void Render(const F &record)
+    {
+        mCount = 0;
+        stats.last = FrameCost();
+        record(*this);
+        const uint16_t count = mCount;
+        BeginFrame();
+        do
+        {
+            ReplayPage(min(count, DISPLAY_LIST_SIZE));
+            if (count > DISPLAY_LIST_SIZE)
+            {
+                // The commands that did not fit
+                mImmediate = true;
+                mCount = 0;
+                record(*this);
+                DrawPending();
+                mImmediate = false;
+            }
+        } while (NextPage());
+        EndFrame(count);
+    }
+
+    // Forget the worst frame cost (the host resets it before measuring a session)
+    inline void ResetWorst() { stats.worst = FrameCost(); }
+
+    FrameStats stats;
+
+private:
+    DrawCommand mCommands[DISPLAY_LIST_SIZE];
+    // Last command when it's not in the list (it did not fit, or the frame is recorded again)
+    DrawCommand mPending;
+    uint16_t mCount; // commands of the frame so far, in the list or not
+    bool mImmediate; // recording again to draw the commands that did not fit
+
+    void Add(DrawOp op, uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+    DrawCommand *Last();
+    void DrawPending();
+    void DrawOnPage(const DrawCommand &command);
+    void Execute(const DrawCommand &command);
+    void BeginFrame();
+    void ReplayPage(uint8_t count);
+    uint8_t NextPage();
+    void EndFrame(uint16_t count);
+};
+
+extern DisplayList gDisplayList;
+
+#endif
@@ -0,0 +1,91 @@
+#include "DisplayTransfer.h"
+#include "TileKeys.h"
+#include "Util.h"
+
+DisplayStats gDisplayStats;
+
+// Original callback of the I2C transport
+static u8x8_msg_cb sByteCb;
+
+static uint8_t CountingByteCb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+    if (msg == U8X8_MSG_BYTE_SEND)
+        gDisplayStats.bytes += arg_int;
+    else if (msg == U8X8_MSG_BYTE_START_TRANSFER)
+        gDisplayStats.transactions++;
+    if (sByteCb == NULL)
+        return 1;
+
+    const unsigned long start = micros();
+    const uint8_t result = sByteCb(u8x8, msg, arg_int, arg_ptr);
+    gDisplayStats.waitUs += micros() - start;
+    return result;
+}
+
+#if TILE_DIFF
+
+// Original callback of the SSD1306 driver
+static u8x8_msg_cb sDisplayCb;
+
+// Every tile as it is on the display
+static TileKeys sKeys;
+
+static uint8_t TileDiffDisplayCb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+    if (msg != U8X8_MSG_DISPLAY_DRAW_TILE)
+        return sDisplayCb(u8x8, msg, arg_int, arg_ptr);
+
+    const u8x8_tile_t *tiles = static_cast<const u8x8_tile_t *>(arg_ptr);
+    const uint8_t first = tiles->y_pos * TILES_X + tiles->x_pos;
+
+    // Repeated tiles (e.g. clearDisplay()) are rare: send them as they are, just remember them
+    if (arg_int != 1)
+    {
+        for (uint8_t i = 0; i < tiles->cnt * arg_int && tiles->x_pos + i < TILES_X; ++i)
+            sKeys.Sent(first + i, tiles->tile_ptr + (i % tiles->cnt) * 8);
+        gDisplayStats.tilesSent += tiles->cnt * arg_int;
+        return sDisplayCb(u8x8, msg, arg_int, arg_ptr);
+    }
+
+    // First tile of a frame ==> rolling refresh (see TileKeys.h)
+    if (first == 0)
+        sKeys.Refresh();
+
+    u8x8_tile_t run;
+    run.y_pos = tiles->y_pos;
+    uint8_t i = 0;
+    while (i < tiles->cnt)
+    {
+        // Skip unchanged tiles
+        if (!sKeys.Changed(first + i, tiles->tile_ptr + i * 8))
+        {
+            gDisplayStats.tilesSkipped++;
+            ++i;
+            continue;
+        }
+
+        // Send the run of changed tiles starting here
+        const uint8_t start = i++;
+        while (i < tiles->cnt && sKeys.Changed(first + i, tiles->tile_ptr + i * 8))
+            ++i;
+
+        run.tile_ptr = tiles->tile_ptr + start * 8;
+        run.cnt = i - start;
+        run.x_pos = tiles->x_pos + start;
+        sDisplayCb(u8x8, msg, 1, &run);
+        gDisplayStats.tilesSent += run.cnt;
+    }
+    return 1;
+}
+
+#endif
+
+void InstallDisplayTransfer(u8x8_t *u8x8)
+{
+    sByteCb = u8x8->byte_cb;
+    u8x8->byte_cb = CountingByteCb;
+#if TILE_DIFF
+    sDisplayCb = u8x8->display_cb;
+    u8x8->display_cb = TileDiffDisplayCb;
+#endif
+}
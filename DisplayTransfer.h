@@ -0,0 +1,45 @@
+#ifndef DISPLAY_TRANSFER_H
+#define DISPLAY_TRANSFER_H
+
+/*
+    Transfer layer under the u8g2 SSD1306 driver.
+        - Tile diff: u8g2 sends every tile row of every page, every frame (1024 bytes over I2C).
+          The display callback is wrapped to keep the CRC of each 8x8 tile last sent (TileKeys.h),
+          and only runs of changed tiles are forwarded to the driver (which addresses them with
+          the SSD1306 column/page commands). Bus traffic scales with what moves, not with the
+          screen size.
+        - Byte counter: the byte callback (the I2C transport) is wrapped to count bytes and
+          transactions, and the time the CPU spends in it, waiting for the bus.
+          Without a transport it just counts; the host tests put a stand-in of the I2C bus under it
+          (test/stub/U8g2lib.h), and TransferTest compares the traffic with and without the tile diff.
+    The transport itself is Wire (u8g2 HW_I2C), or the TWI interrupt with DISPLAY_ASYNC (see AsyncTwi.h).
+*/
+
+#include <U8g2lib.h>
+
+#include "Util.h"
+#include "AsyncTwi.h"
+
+// Display driven by the games (see Game.h)
+#if DISPLAY_ASYNC
+using Display = U8G2_SSD1306_128X64_NONAME_2_ASYNC_I2C;
+#else
+using Display = U8G2_SSD1306_128X64_NONAME_2_HW_I2C;
+#endif
+
+struct DisplayStats
+{
+    uint32_t bytes;        // bytes sent on the bus (commands and data)
+    uint16_t transactions; // I2C transactions
+    uint16_t tilesSent;
+    uint16_t tilesSkipped; // tiles not sent because they did not change
+    uint32_t waitUs;       // time spent in the transport (blocked by the bus, or queueing with DISPLAY_ASYNC)
+    uint16_t busErrors;    // transactions not acknowledged by the display (DISPLAY_ASYNC only)
+};
+
+extern DisplayStats gDisplayStats;
+
+// Hook the transfer layer into u8x8; call it before u8g2.begin()
+void InstallDisplayTransfer(u8x8_t *u8x8);
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef FONTS_H
+#define FONTS_H
+
+/*
+    Fonts of the firmware, selected in one place: every setFont() goes through these names.
+        FONT_TITLE  big titles ("Pause!", "Game over!"...)
+        FONT_TEXT   everything else (menu, hints, scores)
+    The "_tr" u8g2 variants only hold ASCII 32..127 (the firmware prints nothing else).
+    With FONT_SUBSET set to 1, the fonts are the copies generated by tools/fontsubset.py in
+    FontSubset.cpp, reduced to the glyphs the firmware actually prints (17 and 40 of the 95
+    glyphs). FontSubset.cpp is not in the tree: the tool needs bdfconv and the BDF fonts of the
+    u8g2 repository, run it before building with FONT_SUBSET.
+*/
+
+#include <U8g2lib.h>
+#include "Util.h"
+
+#if FONT_SUBSET
+extern const uint8_t gFontTitle[];
+extern const uint8_t gFontText[];
+#define FONT_TITLE gFontTitle
+#define FONT_TEXT gFontText
+#else
+#define FONT_TITLE u8g2_font_profont22_tr
+#define FONT_TEXT u8g2_font_BitTypeWriter_tr
+#endif
+
+#endif
@@ -3,28 +3,115 @@
 
 #include "Util.h"
 #include "Math.h"
+#include "Snapshot.h"
+#include "DisplayList.h"
+#include "Fonts.h"
+#include "Keys.h"
+#include "DisplayTransfer.h"
 
 #include <U8g2lib.h>
+#if FEATURE_SOUND
 #include <ezBuzzer.h>
+#endif
 
 // Game maps size
 #define MAP_WIDTH 124
 #define MAP_HEIGHT 62
 
-extern U8G2_SSD1306_128X64_NONAME_2_HW_I2C u8g2;
+extern Display u8g2;
+
+#if FEATURE_SOUND
 extern ezBuzzer musicPlayer;
 extern bool gSpeakerOn;
 
-// Map (defined as a rectangle)
+// Short beep on game events, if the speaker is on
+inline void Beep()
+{
+    if (gSpeakerOn) musicPlayer.beep(10);
+}
+#else
+inline void Beep() {}
+#endif
+
+/*
+    Replacement for u8g2.nextPage() used by every firstPage()/nextPage() loop:
+    it's the one place where a finished page buffer can be looked at before it's flushed
+*/
+uint8_t NextPage();
+
+/*
+    Map (defined as a rectangle) described at compile time.
+    Games are templates on their map, so every bound check, centre position and spawn range
+    is folded into an immediate instead of being loaded from memory.
+    Different board sizes are just different instantiations.
+*/
+template <uint8_t X, uint8_t Y, uint8_t WIDTH, uint8_t HEIGHT>
 struct Map
 {
-    vec2i pos;  
-    uint8_t width;
-    uint8_t height;
+    static_assert(WIDTH > 0 && HEIGHT > 0, "Map cannot be empty");
+    static_assert(X + WIDTH <= SCREEN_WIDTH && Y + HEIGHT <= SCREEN_HEIGHT, "Map must fit the display");
+
+    static constexpr uint8_t x = X;
+    static constexpr uint8_t y = Y;
+    static constexpr uint8_t width = WIDTH;
+    static constexpr uint8_t height = HEIGHT;
+    // First column/row outside the map
+    static constexpr uint8_t right = X + WIDTH;
+    static constexpr uint8_t bottom = Y + HEIGHT;
+    static constexpr uint8_t centerX = X + WIDTH / 2;
+    static constexpr uint8_t centerY = Y + HEIGHT / 2;
+
+    static constexpr bool Contains(uint8_t px, uint8_t py) { return px >= X && px < right && py >= Y && py < bottom; }
+    static inline bool Inside(const vec2i &p) { return Contains(p.x, p.y); }
+    static inline void DrawFrame(DisplayList &list) { list.Frame(X, Y, WIDTH, HEIGHT); }
+};
+
+/*
+    World that can be bigger than the screen (16-bit coordinates, origin in 0,0), seen through
+    the viewport VIEW (a Map on the display).
+    The camera is the world position shown in the top-left corner of the viewport.
+*/
+template <uint16_t WIDTH, uint16_t HEIGHT, class VIEW>
+struct World
+{
+    static_assert(WIDTH >= VIEW::width && HEIGHT >= VIEW::height, "World must be at least as big as its viewport");
+    static_assert(WIDTH <= 0x7FFF && HEIGHT <= 0x7FFF, "World coordinates are signed 16-bit");
+
+    using View = VIEW;
+    static constexpr uint16_t width = WIDTH;
+    static constexpr uint16_t height = HEIGHT;
+
+    static constexpr bool Contains(int16_t px, int16_t py) { return px >= 0 && px < WIDTH && py >= 0 && py < HEIGHT; }
+    static inline bool Inside(const vec2w &p) { return Contains(p.x, p.y); }
+
+    // Camera keeping p in the centre of the viewport, without ever showing outside the world
+    static inline vec2w Follow(const vec2w &p)
+    {
+        return {constrain(p.x - VIEW::width / 2, 0, WIDTH - VIEW::width), constrain(p.y - VIEW::height / 2, 0, HEIGHT - VIEW::height)};
+    }
+
+    // Screen position of a world position, and if it's inside the viewport
+    static inline vec2w ToScreen(const vec2w &p, const vec2w &camera) { return {VIEW::x + p.x - camera.x, VIEW::y + p.y - camera.y}; }
+    static inline bool Visible(const vec2w &p, const vec2w &camera)
+    {
+        return static_cast<uint16_t>(p.x - camera.x) < VIEW::width && static_cast<uint16_t>(p.y - camera.y) < VIEW::height;
+    }
+
+    // Draw the viewport sides that are world walls (the others just scroll)
+    static inline void DrawWalls(DisplayList &list, const vec2w &camera)
+    {
+        if (camera.x == 0) list.VLine(VIEW::x, VIEW::y, VIEW::height);
+        if (camera.x == WIDTH - VIEW::width) list.VLine(VIEW::right - 1, VIEW::y, VIEW::height);
+        if (camera.y == 0) list.HLine(VIEW::x, VIEW::y, VIEW::width);
+        if (camera.y == HEIGHT - VIEW::height) list.HLine(VIEW::x, VIEW::bottom - 1, VIEW::width);
+    }
 };
 
 // map for snake (same for pong game)
-const Map snakeMap = {vec2i{2, 2}, MAP_WIDTH, MAP_HEIGHT};
+using SnakeMap = Map<2, 2, MAP_WIDTH, MAP_HEIGHT>;
+using PongMap = SnakeMap;
+// Snake world is 2x2 screens, scrolling inside the snake map
+using SnakeWorld = World<2 * MAP_WIDTH, 2 * MAP_HEIGHT, SnakeMap>;
 
 // current game state (used also for menu)
 enum struct GameState
@@ -36,17 +123,63 @@ enum struct GameState
     MATCH_ENDED = 4
 };
 
+// Game identifiers (first byte of the telemetry state)
+enum struct GameId : uint8_t
+{
+    MENU  = 0,
+    SNAKE = 1,
+    PONG  = 2
+};
+
+/*
+    Games are driven by events, each with its own hook:
+        - OnKey: a key was pressed (or is held, Key::REPEAT)
+        - Tick: one fixed time step (GAME_TICK_MS) passed, only called while the game is not idle
+        - Render: draw the screen, only called when a key or a tick changed it (see Invalidate)
+    so a spin without key nor tick costs nothing, and several ticks can be drawn as one frame.
+*/
 class Game
 {
 public:
     virtual ~Game() = default;
-    virtual void Update(int input) = 0;
+    virtual void OnKey(Key key) = 0;
+    virtual void Tick() {}
+
+    // Does the screen need to be drawn again, and draw it
+    virtual bool NeedsRender() const { return mDirty; }
+    virtual void Render()
+    {
+        mDirty = false;
+        Draw();
+    }
+
+    /*
+        Write a compact snapshot of the game for telemetry (at most FRAME_MAX_PAYLOAD bytes).
+        It always starts with | GameId | GameState | followed by game specific fields.
+        Returns the number of bytes written
+    */
+    virtual uint8_t WriteState(uint8_t *buffer) const = 0;
+
+    // Write everything needed to resume the game (see Snapshot.h), and read it back (game resumes paused)
+    virtual void Save(SnapshotWriter &writer) const {}
+    virtual void Load(SnapshotReader &reader) {}
 
     inline GameState GetState() const { return mState; }
 
+    // True when the screen does not change without a key (pause, game over...): no need to tick until then
+    virtual bool IsIdle() const { return mState == GameState::PAUSE || mState == GameState::FINISHED; }
+
 protected:
     GameState mState;
-    Game(GameState state) : mState(state) {}
+    Game(GameState state) : mState(state), mDirty(true) {}
+
+    // The screen changed: draw it at the next Render
+    inline void Invalidate() { mDirty = true; }
+    // Draw the screen of the current state
+    virtual void Draw() const = 0;
+
+private:
+    bool mDirty;
 };
 
 inline void DrawPauseScreen()
@@ -56,17 +189,17 @@ inline void DrawPauseScreen()
     do
     {
         // Set font
-        u8g2.setFont(u8g2_font_profont22_tf);
+        u8g2.setFont(FONT_TITLE);
         u8g2.setCursor(5, 15);
 
         u8g2.print(F("Pause!"));
 
         // Set font
-        u8g2.setFont(u8g2_font_BitTypeWriter_tr);
+        u8g2.setFont(FONT_TEXT);
         u8g2.setCursor(5, 35);
 
         u8g2.print(F("Press play to resume"));
-    } while (u8g2.nextPage());
+    } while (NextPage());
 }
 
 inline void DrawGameOver(uint8_t score)
@@ -75,13 +208,13 @@ inline void DrawGameOver(uint8_t score)
     do
     {
         // Set font
-        u8g2.setFont(u8g2_font_profont22_tf);
+        u8g2.setFont(FONT_TITLE);
         u8g2.setCursor(5, 15);
 
         u8g2.print(F("Game over!"));
         
         // Set font
-        u8g2.setFont(u8g2_font_BitTypeWriter_tr);
+        u8g2.setFont(FONT_TEXT);
         u8g2.setCursor(5, 35);
 
         u8g2.print(F("Score "));
@@ -89,7 +222,7 @@ inline void DrawGameOver(uint8_t score)
 
         u8g2.setCursor(5, 50);
         u8g2.print(F("'play' -> menu"));
-    } while (u8g2.nextPage());
+    } while (NextPage());
 }
 
 inline void DrawYouWin(uint8_t score)
@@ -98,13 +231,13 @@ inline void DrawYouWin(uint8_t score)
     do
     {
         // Set font
-        u8g2.setFont(u8g2_font_profont22_tf);
+        u8g2.setFont(FONT_TITLE);
         u8g2.setCursor(5, 15);
 
         u8g2.print(F("You win!"));
 
         // Set font
-        u8g2.setFont(u8g2_font_BitTypeWriter_tr);
+        u8g2.setFont(FONT_TEXT);
         u8g2.setCursor(5, 35);
 
         u8g2.print(F("Score "));
@@ -112,7 +245,7 @@ inline void DrawYouWin(uint8_t score)
 
         u8g2.setCursor(5, 50);
         u8g2.print(F("'play' -> menu"));
-    } while (u8g2.nextPage());
+    } while (NextPage());
 }
 
 #endif
@@ -1,9 +1,20 @@
+#include "Util.h"
+
 #include <IRremote.h>   // Infrared module library
 #include <U8g2lib.h>    // Display library
+#if FEATURE_SOUND
 #include <ezBuzzer.h>   // Buzzer library
+#endif
 
-#include "Util.h"
 #include "Menu.h"
+#include "Protocol.h"
+#include "Mirror.h"
+#include "DisplayTransfer.h"
+#include "Random.h"
+#include "Power.h"
+#include "Profile.h"
+#include "Keys.h"
+#include "Latency.h"
 
 // Initialize display (global variable)
 /* 
@@ -12,63 +23,230 @@
         - First half is first page
         - Second half is second page
     This allow us to load in memory only half display buffer
+    (see DisplayTransfer.h for the transport of the pages to the display)
 */
-U8G2_SSD1306_128X64_NONAME_2_HW_I2C u8g2(U8G2_R0);
+Display u8g2(U8G2_R0);
 
 // Initialize IR Receiver on pin 7 (global variable)
 IRrecv irrecv(IR_PIN);
 decode_results results;
 
+#if FEATURE_SOUND
 ezBuzzer musicPlayer(BUZZER_PIN);
 
 // Boolean used for enabling/disabling buzzer beep
 bool gSpeakerOn = true;
+#endif
+
+// Welcome screen duration (ms); it does not block: any key skips it
+#define SPLASH_DURATION 2000
+bool gSplashOn = false;
+unsigned long gSplashStart;
 
 Menu menu;
 
+// Time of the last game tick
+unsigned long gLastTick;
+
+// Longest idle sleep on a static screen (ms)
+#define IDLE_WAKE_MS 1000
+
+uint8_t NextPage()
+{
+#if SCREEN_MIRROR
+    // The page buffer is still complete here, it will be cleared by nextPage()
+    gMirror.CapturePage();
+#endif
+    const uint8_t morePages = u8g2.nextPage();
+    if (!morePages)
+    {
+#if SCREEN_MIRROR
+        gMirror.EndFrame();
+#endif
+        gLatency.FrameDrawn();
+        // Last page sent: the whole frame is on the display (asynchronous transport: see loop())
+#if !DISPLAY_ASYNC
+        gLatency.FrameFlushed(millis());
+#endif
+    }
+    return morePages;
+}
+
 inline void DrawWelcome()
 {
     u8g2.firstPage();
     do
     {
-        u8g2.setFont(u8g2_font_profont22_tf);
+        u8g2.setFont(FONT_TITLE);
         u8g2.setCursor(5, 20);
 
         u8g2.print(F("GamePad"));
         
-        u8g2.setFont(u8g2_font_BitTypeWriter_tr);
+        u8g2.setFont(FONT_TEXT);
         u8g2.setCursor(38, 55);
 
         u8g2.print(F("E. Rinaldi"));
-    } while (u8g2.nextPage());
+    } while (NextPage());
 }
 
 void setup(void)
 {
-    Serial.begin(9600);
-
+#if FEATURE_SERIAL
+    gLink.Begin(SERIAL_BAUD);
+#endif
     irrecv.enableIRIn();
+#if PROFILE
+    ProfileBegin();
+#endif
+
+    // Every game gets its own sequence (the host can force a seed to replay a game)
+    gRandomSeed = NoiseSeed(NOISE_PIN);
 
+    // Only changed tiles are sent to the display (and bus traffic is counted)
+    InstallDisplayTransfer(u8g2.getU8x8());
     u8g2.begin();
-    DrawWelcome();
-    delay(2000);
+    // Resume the game saved before power loss, otherwise say hello
+    if (!menu.Resume())
+    {
+        DrawWelcome();
+        gSplashOn = true;
+        gSplashStart = millis();
+    }
+}
+
+// Stream the game state after every event
+inline void StreamState()
+{
+#if FEATURE_SERIAL
+    if (gLink.IsTelemetryOn())
+        gLink.Send(MessageType::STATE, menu.WriteState(gLink.Payload()));
+#endif
+}
+
+// A key waits to be handled: from the IR remote (decode() keeps it until resume()) or the host
+bool KeyPending()
+{
+    if (irrecv.decode(&results))
+        return true;
+#if FEATURE_SERIAL
+    if (Serial.available() > 0)
+        return true;
+#endif
+    return false;
+}
+
+// Sleep until `deadline` (millis()) or the next key, or only for a millisecond while something
+// must be followed: a beep to end, a frame on its way to the display
+void SleepUntil(unsigned long deadline)
+{
+#if FEATURE_SOUND
+    if (musicPlayer.getState() != BUZZER_IDLE)
+        deadline = millis() + 1;
+#endif
+#if DISPLAY_ASYNC
+    if (AsyncTwiBusy())
+        deadline = millis() + 1;
+#endif
+    IdleSleep(deadline, KeyPending);
+}
+
+// Route a key (from the IR remote or the Serial link) to the buzzer "volume" or to menu/games
+void HandleKey(Key key)
+{
+    // Any key skips the welcome screen
+    if (gSplashOn) gSplashOn = false;
+#if FEATURE_SOUND
+    // If the user pressed volume up key ==> enable buzzer
+    if (key == Key::VOL_UP) gSpeakerOn = true;
+    // If the user pressed volume down key ==> disable buzzer
+    else if (key == Key::VOL_DOWN) gSpeakerOn = false;
+    // Remotes without volume keys toggle it
+    else if (key == Key::SOUND) gSpeakerOn = !gSpeakerOn;
+    // Otherwise it's an input for menu/games
+    else
+#endif
+    {
+        const bool traced = gLatency.KeyHandled(millis());
+        menu.OnKey(key);
+        // Nothing will be drawn for this key (e.g. a key without effect on the pause screen)
+        if (traced && menu.IsIdle() && !menu.NeedsRender())
+            gLatency.Cancel();
+        StreamState();
+    }
 }
 
 void loop(void)
 {
+#if FEATURE_SOUND
     // Make buzzer wait for beeping (non blocking op.)
     musicPlayer.loop();
+#endif
+    const unsigned long now = millis();
+    if (gSplashOn && now - gSplashStart >= SPLASH_DURATION)
+        gSplashOn = false;
+
+#if FEATURE_SERIAL
+    // Time to first interactive frame: the first loop is the first moment keys are handled
+    // and the welcome screen or the resumed game is on screen
+    if (gLink.counters.firstFrameMs == 0)
+        gLink.counters.firstFrameMs = now;
+#endif
+
     // If receive something via IR ==> update input (i.e. update menu or games or buzzer "volume")
     if (irrecv.decode(&results))
     {
         irrecv.resume();
-        // If the user pressed volume up key ==> enable buzzer
-        if(results.value == VOL_UP_KEY) gSpeakerOn = true;
-        // If the user pressed volume down key ==> disable buzzer
-        else if (results.value == VOL_DOWN_KEY) gSpeakerOn = false;
-        // Otherwise it's an input for menu/games
-        else menu.Update(results.value);
+#if FEATURE_SERIAL
+        gLink.counters.irKeys++;
+#endif
+        HandleKey(DecodeKey(results.value));
     }
-    // If not receiving anything ==> send invalid input
-    else menu.Update(-2);
+#if FEATURE_SERIAL
+    // Keys injected by the host go through the same path
+    else
+    {
+        unsigned long code;
+        if (gLink.Poll(code)) HandleKey(DecodeKey(code));
+    }
+#endif
+
+    // Nothing moves nor is drawn while on the welcome screen
+    if (gSplashOn)
+    {
+        SleepUntil(gSplashStart + SPLASH_DURATION);
+        return;
+    }
+
+    // Fixed time steps: run the ticks due since the last one (a static screen does not
+    // accumulate any), at most GAME_TICK_BATCH of them before drawing
+    if (menu.IsIdle())
+        gLastTick = now;
+    for (uint8_t batch = 0; now - gLastTick >= GAME_TICK_MS && !menu.IsIdle(); ++batch)
+    {
+        if (batch == GAME_TICK_BATCH)
+        {
+            gLastTick = now;
+            break;
+        }
+        gLastTick += GAME_TICK_MS;
+        menu.Tick();
+#if FEATURE_SERIAL
+        gLink.counters.ticks++;
+#endif
+        StreamState();
+    }
+
+#if DISPLAY_ASYNC
+    // The last frame drawn is on the display once the transport queue is empty
+    if (!AsyncTwiBusy())
+        gLatency.FrameFlushed(now);
+#endif
+
+    // One frame for every key and tick since the last one, if they changed the screen
+    if (menu.NeedsRender())
+        menu.Render();
+    // Nothing to do before the next tick or key (a static screen only waits for a key, it wakes
+    // up every IDLE_WAKE_MS anyway)
+    else
+        SleepUntil(menu.IsIdle() ? now + IDLE_WAKE_MS : gLastTick + GAME_TICK_MS);
 }
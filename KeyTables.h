@@ -0,0 +1,88 @@
+// Generated by tools/keyhash.py, do not edit
+
+#ifndef KEY_TABLES_H
+#define KEY_TABLES_H
+
+#include "Keys.h"
+
+#if REMOTE_LAYOUT == REMOTE_ELEGOO
+// 19 keys in 32 slots
+#define KEY_HASH_BITS 5
+#define KEY_HASH_MULTIPLIER 0x01FD
+static const KeyEntry KEY_TABLE[1 << KEY_HASH_BITS] PROGMEM = {
+    {0xFFFFFFFF, Key::REPEAT},
+    {0x00000000, Key::NONE},
+    {0x00000000, Key::NONE},
+    {0x00FFE01F, Key::DOWN},
+    {0x00000000, Key::NONE},
+    {0x00000000, Key::NONE},
+    {0x00000000, Key::NONE},
+    {0x00FFC23D, Key::RIGHT},
+    {0x00000000, Key::NONE},
+    {0x00000000, Key::NONE},
+    {0x00FFA857, Key::VOL_DOWN},
+    {0x00FFA25D, Key::POWER},
+    {0x00000000, Key::NONE},
+    {0x00FF906F, Key::UP},
+    {0x00000000, Key::NONE},
+    {0x00000000, Key::NONE},
+    {0x00FF7A85, Key::DIGIT_3},
+    {0x00000000, Key::NONE},
+    {0x00FF6897, Key::DIGIT_0},
+    {0x00FF629D, Key::VOL_UP},
+    {0x00FF5AA5, Key::DIGIT_6},
+    {0x00FF52AD, Key::DIGIT_9},
+    {0x00FF4AB5, Key::DIGIT_8},
+    {0x00FF42BD, Key::DIGIT_7},
+    {0x00FF38C7, Key::DIGIT_5},
+    {0x00FF30CF, Key::DIGIT_1},
+    {0x00000000, Key::NONE},
+    {0x00FF22DD, Key::LEFT},
+    {0x00FF18E7, Key::DIGIT_2},
+    {0x00FF10EF, Key::DIGIT_4},
+    {0x00000000, Key::NONE},
+    {0x00FF02FD, Key::PLAY_PAUSE},
+};
+#elif REMOTE_LAYOUT == REMOTE_KEYES
+// 18 keys in 32 slots
+#define KEY_HASH_BITS 5
+#define KEY_HASH_MULTIPLIER 0x01FD
+static const KeyEntry KEY_TABLE[1 << KEY_HASH_BITS] PROGMEM = {
+    {0xFFFFFFFF, Key::REPEAT},
+    {0x00000000, Key::NONE},
+    {0x00000000, Key::NONE},
+    {0x00000000, Key::NONE},
+    {0x00000000, Key::NONE},
+    {0x00000000, Key::NONE},
+    {0x00000000, Key::NONE},
+    {0x00FFC23D, Key::RIGHT},
+    {0x00000000, Key::NONE},
+    {0x00FFB04F, Key::DIGIT_3},
+    {0x00FFA857, Key::DOWN},
+    {0x00000000, Key::NONE},
+    {0x00FF9867, Key::DIGIT_2},
+    {0x00000000, Key::NONE},
+    {0x00000000, Key::NONE},
+    {0x00000000, Key::NONE},
+    {0x00FF7A85, Key::DIGIT_6},
+    {0x00000000, Key::NONE},
+    {0x00FF6897, Key::DIGIT_1},
+    {0x00FF629D, Key::UP},
+    {0x00FF5AA5, Key::DIGIT_9},
+    {0x00FF52AD, Key::SOUND},
+    {0x00FF4AB5, Key::DIGIT_0},
+    {0x00FF42BD, Key::POWER},
+    {0x00FF38C7, Key::DIGIT_8},
+    {0x00FF30CF, Key::DIGIT_4},
+    {0x00000000, Key::NONE},
+    {0x00FF22DD, Key::LEFT},
+    {0x00FF18E7, Key::DIGIT_5},
+    {0x00FF10EF, Key::DIGIT_7},
+    {0x00000000, Key::NONE},
+    {0x00FF02FD, Key::PLAY_PAUSE},
+};
+#else
+#error "Unknown REMOTE_LAYOUT"
+#endif
+
+#endif
@@ -0,0 +1,13 @@
+#include "Keys.h"
+#include "KeyTables.h"
+
+Key DecodeKey(uint32_t code)
+{
+    // Same hash as tools/keyhash.py: fold to 16 bits, multiply, keep the top KEY_HASH_BITS
+    const uint16_t folded = code ^ code >> 16;
+    const uint8_t slot = static_cast<uint16_t>(folded * KEY_HASH_MULTIPLIER) >> (16 - KEY_HASH_BITS);
+    KeyEntry entry;
+    memcpy_P(&entry, &KEY_TABLE[slot], sizeof(entry));
+    // Every code lands in a slot: only the one stored there is a key
+    return entry.code == code ? entry.key : Key::NONE;
+}
@@ -0,0 +1,48 @@
+#ifndef KEYS_H
+#define KEYS_H
+
+/*
+    Keys of the GamePad. Raw 32-bit IR codes are mapped to a Key once, when they are received,
+    so games switch on a small dense enum instead of comparing 32-bit codes.
+    The mapping is a perfect hash table in PROGMEM per remote layout (REMOTE_LAYOUT in Util.h),
+    generated by tools/keyhash.py in KeyTables.h.
+*/
+
+#include "Arduino.h"
+#include "Util.h"
+
+enum struct Key : uint8_t
+{
+    NONE, // no key (or a code unknown to the remote layout)
+    POWER,
+    VOL_UP,
+    VOL_DOWN,
+    SOUND, // toggle the buzzer (remotes without volume keys)
+    PLAY_PAUSE,
+    UP,
+    DOWN,
+    LEFT,
+    RIGHT,
+    DIGIT_0,
+    DIGIT_1,
+    DIGIT_2,
+    DIGIT_3,
+    DIGIT_4,
+    DIGIT_5,
+    DIGIT_6,
+    DIGIT_7,
+    DIGIT_8,
+    DIGIT_9,
+    REPEAT // the last key is still held
+};
+
+struct KeyEntry
+{
+    uint32_t code;
+    Key key;
+};
+
+// Map a raw IR code to a key of the remote layout
+Key DecodeKey(uint32_t code);
+
+#endif
@@ -0,0 +1,23 @@
+#include "Latency.h"
+
+LatencyTrace gLatency;
+
+void LatencyTrace::FrameFlushed(unsigned long now)
+{
+    if (!mDrawn)
+        return;
+    mPending = false;
+    mDrawn = false;
+
+    const unsigned long latency = now - mStart;
+    const uint16_t ms = latency > 0xFFFF ? 0xFFFF : latency;
+    // log2 buckets from 8ms: one shift per bucket
+    uint8_t bucket = 0;
+    for (uint16_t limit = ms >> 3; limit > 0 && bucket < LATENCY_BUCKETS - 1; limit >>= 1)
+        ++bucket;
+
+    stats.keys++;
+    stats.totalMs += ms;
+    stats.worstMs = max(stats.worstMs, ms);
+    stats.buckets[bucket]++;
+}
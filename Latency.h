@@ -0,0 +1,60 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+/*
+    Input-to-photon latency: the time from a key handed to the menu/games in loop() to the end
+    of the first frame completely sent to the display after it (the last nextPage() of a frame
+    returns once its page is on the SSD1306, or once it's queued with DISPLAY_ASYNC: the frame is
+    then on the display when the transport queue is empty).
+    One key is traced at a time: keys arriving before that frame are part of the same trace,
+    timed from the first one. A key that changes nothing on a static screen is not traced, no
+    frame will ever show it. The host reads the histogram with GET_LATENCY.
+*/
+
+#include "Arduino.h"
+
+// Bucket i counts latencies below 8 << i ms, the last one everything above
+#define LATENCY_BUCKETS 6
+
+struct LatencyStats
+{
+    uint16_t keys;    // traces completed
+    uint16_t worstMs; // longest trace
+    uint32_t totalMs; // sum of the traces (for the average)
+    uint16_t buckets[LATENCY_BUCKETS];
+};
+
+class LatencyTrace
+{
+public:
+    LatencyTrace() : mPending(false), mDrawn(false) {}
+
+    // A key was handed to the menu/games at `now` (millis); returns true if it starts a trace
+    inline bool KeyHandled(unsigned long now)
+    {
+        if (mPending)
+            return false;
+        mStart = now;
+        mPending = true;
+        return true;
+    }
+    // The key starting the trace will not change the screen: forget it
+    inline void Cancel() { mPending = false; }
+    // A frame has been drawn (and sent, or queued for the display)
+    inline void FrameDrawn() { mDrawn = mPending; }
+    // The last frame drawn is completely on the display at `now` (millis)
+    void FrameFlushed(unsigned long now);
+
+    inline void Reset() { stats = LatencyStats(); }
+
+    LatencyStats stats;
+
+private:
+    unsigned long mStart;
+    bool mPending;
+    bool mDrawn; // the frame showing the pending key has been drawn
+};
+
+extern LatencyTrace gLatency;
+
+#endif
@@ -0,0 +1,90 @@
+#include "Level.h"
+#include "LevelData.h"
+
+#if GAME_SNAKE
+
+static_assert(Obstacles<SnakeWorld>::tilesX == LEVEL_TILES_X && Obstacles<SnakeWorld>::tilesY == LEVEL_TILES_Y,
+              "LevelData.h was generated for another world size, update tools/levelpack.py");
+
+Level GetLevel(uint8_t index)
+{
+    Level level;
+    memcpy_P(&level, &LEVELS[index], sizeof(level));
+    return level;
+}
+
+uint8_t GetLevelCount() { return LEVEL_COUNT; }
+
+// Set or clear the tiles [first, first + length) of a bitmap, up to 8 at a time
+static void FillTiles(uint8_t *tiles, uint16_t first, uint8_t length, bool solid)
+{
+    const uint16_t end = first + length;
+    while (first < end)
+    {
+        const uint8_t bit = first & 7;
+        const uint8_t count = min(8 - bit, end - first);
+        const uint8_t mask = ((1 << count) - 1) << bit;
+        uint8_t &byte = tiles[first >> 3];
+        byte = solid ? byte | mask : byte & ~mask;
+        first += count;
+    }
+}
+
+// Free and obstacle runs are written alike, a byte at a time: at most one write per bitmap byte
+// plus one per run, whatever the obstacles
+template <class W>
+void Obstacles<W>::Load(const uint8_t *runs)
+{
+    mRuns = runs;
+    for (uint16_t tile = 0; tile < tilesX * tilesY;)
+    {
+        const uint8_t run = pgm_read_byte(runs++);
+        const uint8_t length = (run & 0x7F) + 1;
+        FillTiles(mTiles, tile, length, run & 0x80);
+        tile += length;
+    }
+}
+
+template <class W>
+void Obstacles<W>::Draw(DisplayList &list, const vec2w &camera) const
+{
+    // Tile rows in sight: the runs after the last one are not even read
+    const uint8_t top = camera.y >> 3;
+    const uint8_t bottom = (camera.y + W::View::height - 1) >> 3;
+    const uint8_t *runs = mRuns;
+    uint8_t x = 0, y = 0;
+    while (y <= bottom)
+    {
+        const uint8_t run = pgm_read_byte(runs++);
+        uint8_t length = (run & 0x7F) + 1;
+        // A run can go on over the next rows
+        while (length > 0 && y <= bottom)
+        {
+            const uint8_t span = min(length, static_cast<uint8_t>(tilesX - x));
+            if ((run & 0x80) && y >= top)
+            {
+                // Clip the obstacle span to the viewport, in world coordinates
+                const int16_t left = max(x * 8, camera.x);
+                const int16_t right = min((x + span) * 8, camera.x + W::View::width);
+                const int16_t upper = max(y * 8, camera.y);
+                const int16_t lower = min(y * 8 + 8, camera.y + W::View::height);
+                if (left < right)
+                {
+                    const vec2w &screen = W::ToScreen({left, upper}, camera);
+                    list.Box(screen.x, screen.y, right - left, lower - upper);
+                }
+            }
+            x += span;
+            length -= span;
+            if (x == tilesX)
+            {
+                x = 0;
+                y++;
+            }
+        }
+    }
+}
+
+template class Obstacles<SnakeWorld>;
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+/*
+    Snake levels: obstacles on a grid of 8x8-pixel tiles, plus where and how fast the snake starts.
+    Levels live in flash (LevelData.h, generated by tools/levelpack.py) as runs of tiles in row
+    order, one byte per run: bit 7 = obstacle, bits 0-6 = run length - 1.
+    Loading a level decodes the runs straight into a bitmap of the world tiles (one bit per tile):
+    checking a cell is then a single bit test, whatever the number of obstacles. Obstacles are
+    drawn from the runs in flash, there's no other copy of the level in SRAM.
+*/
+
+#include "Game.h"
+
+struct Level
+{
+    uint8_t x, y;        // start cell of the snake
+    int8_t dx, dy;       // start direction
+    uint8_t rate;        // start speed (4.4 fixed point, like SNAKE_BASE_RATE)
+    const uint8_t *runs; // obstacles (PROGMEM)
+};
+
+// Copy a level header from flash
+Level GetLevel(uint8_t index);
+uint8_t GetLevelCount();
+
+// Obstacles of the world W
+template <class W>
+class Obstacles
+{
+public:
+    static constexpr uint8_t tilesX = (W::width + 7) >> 3;
+    static constexpr uint8_t tilesY = (W::height + 7) >> 3;
+
+    Obstacles(const uint8_t *runs) { Load(runs); }
+    void Load(const uint8_t *runs);
+
+    // Is the cell p (inside the world) on an obstacle
+    inline bool Blocked(const vec2w &p) const
+    {
+        const uint16_t tile = (p.y >> 3) * tilesX + (p.x >> 3);
+        return mTiles[tile >> 3] & (1 << (tile & 7));
+    }
+    // Does a square of `size` (at most a tile) at p touch an obstacle
+    inline bool Overlaps(const vec2w &p, uint8_t size) const
+    {
+        return Blocked(p) || Blocked({p.x + size - 1, p.y}) || Blocked({p.x, p.y + size - 1}) ||
+               Blocked({p.x + size - 1, p.y + size - 1});
+    }
+
+    // Draw the obstacles inside the viewport of W
+    void Draw(DisplayList &list, const vec2w &camera) const;
+
+private:
+    uint8_t mTiles[(tilesX * tilesY + 7) / 8];
+    const uint8_t *mRuns;
+};
+
+// Instantiated in Level.cpp
+extern template class Obstacles<SnakeWorld>;
+
+#endif
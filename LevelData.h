@@ -0,0 +1,25 @@
+// Generated by tools/levelpack.py, do not edit
+
+#ifndef LEVEL_DATA_H
+#define LEVEL_DATA_H
+
+#include "Level.h"
+
+#define LEVEL_TILES_X 31
+#define LEVEL_TILES_Y 16
+#define LEVEL_COUNT 3
+
+// Open field: 4 runs
+static const uint8_t LEVEL_0_RUNS[] PROGMEM = {0x7F, 0x7F, 0x7F, 0x6F};
+// Pillars: 26 runs
+static const uint8_t LEVEL_1_RUNS[] PROGMEM = {0x61, 0x81, 0x06, 0x81, 0x06, 0x81, 0x0A, 0x81, 0x06, 0x81, 0x06, 0x81, 0x7F, 0x44, 0x81, 0x06, 0x81, 0x06, 0x81, 0x0A, 0x81, 0x06, 0x81, 0x06, 0x81, 0x62};
+// Corridors: 13 runs
+static const uint8_t LEVEL_2_RUNS[] PROGMEM = {0x7F, 0x96, 0x31, 0x80, 0x1D, 0x80, 0x1D, 0x80, 0x1D, 0x80, 0x31, 0x96, 0x7F};
+
+static const Level LEVELS[LEVEL_COUNT] PROGMEM = {
+    {10, 10, 1, 0, 16, LEVEL_0_RUNS}, // Open field
+    {10, 10, 1, 0, 16, LEVEL_1_RUNS}, // Pillars
+    {10, 10, 1, 0, 20, LEVEL_2_RUNS}, // Corridors
+};
+
+#endif
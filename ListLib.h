@@ -28,11 +28,13 @@ public:
 	size_t Count() const;
 
 	T& operator[](const size_t index);
+	const T& operator[](const size_t index) const;
 
 	bool Contains(T item);
 	size_t IndexOf(T item);
 
 	T& First();
+	const T& First() const;
 	T& Last();
 
 	void Add(T item);
@@ -103,6 +105,12 @@ T& List<T>::operator[](const size_t index)
 	return _items[index];
 }
 
+template <typename T>
+const T& List<T>::operator[](const size_t index) const
+{
+	return _items[index];
+}
+
 template <typename T>
 size_t List<T>::Capacity() const
 {
@@ -121,6 +129,12 @@ T& List<T>::First()
 	return _items[0];
 }
 
+template <typename T>
+const T& List<T>::First() const
+{
+	return _items[0];
+}
+
 template <typename T>
 T& List<T>::Last()
 {
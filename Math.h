@@ -6,7 +6,8 @@
     Following choices are made for optimizing memory:
         - Points and vectors are same thing (basically 2d coordinates)
         - Only 2d vectors have been implemented
-        - Since the screen space is mapped by only positive low integers we use uint8_t as main type
+        - Screen coordinates (0..127) and directions fit a signed byte, so vec2i is two int8_t packed in 16 bits
+        - Worlds bigger than the screen use vec2w (16-bit signed coordinates)
 */
 
 #include "Arduino.h"
@@ -15,67 +16,63 @@
 // Positive modulo operation (e.g. -1 modulo 3 should give 2 not -1 like '%' operator does)
 static inline int posmod(int i, int n) { return (i % n + n) % n; }
 
-struct vec2f
+/*
+    Signed 2d integer vector packed in a single 16-bit word (x in the low byte, y in the high byte).
+    Addition, subtraction and comparison work on the whole word at once (SIMD within a register):
+    the top bit of each lane is handled apart, so a carry or borrow out of x never reaches y.
+*/
+union vec2i
 {
-    float x, y;
-    
-    inline vec2f operator+(const vec2f &other) const { return {x + other.x, y + other.y}; }
-    inline vec2f &operator+=(const vec2f &other)
+    uint16_t word;
+    struct
     {
-        x += other.x;
-        y += other.y;
-        return *this;
-    }
-
-    inline vec2f operator-(const vec2f &other) const { return {x - other.x, y - other.y}; }
-    inline vec2f operator-() const { return {-x, -y}; }
-    inline vec2f operator*(const vec2f &other) const { return {x * other.x, y * other.y}; }
-    inline vec2f operator/(const vec2f &other) const { return {x / other.x, y / other.y}; }
+        int8_t x, y;
+    };
 
-    inline bool operator==(const vec2f &other) const { return x == other.x && y == other.y; }
-    inline bool operator!=(const vec2f &other) const { return !(*this == other); }
-};
+    vec2i() = default;
+    constexpr vec2i(int px, int py) : word(static_cast<uint8_t>(px) | static_cast<uint16_t>(static_cast<uint8_t>(py)) << 8) {}
 
-struct vec2i
-{
-    uint8_t x, y;
+    static inline vec2i FromWord(uint16_t word)
+    {
+        vec2i v;
+        v.word = word;
+        return v;
+    }
 
-    inline vec2i operator+(const vec2i &other) const { return {x + other.x, y + other.y}; }
-    inline vec2i &operator+=(const vec2i &other)
+    // Wrapping (modulo 256 per component)
+    inline vec2i operator+(const vec2i &other) const
     {
-        x += other.x;
-        y += other.y;
-        return *this;
+        return FromWord(((word & 0x7F7F) + (other.word & 0x7F7F)) ^ ((word ^ other.word) & 0x8080));
     }
+    inline vec2i operator-(const vec2i &other) const
+    {
+        return FromWord(((word | 0x8080) - (other.word & 0x7F7F)) ^ ((word ^ ~other.word) & 0x8080));
+    }
+    inline vec2i operator-() const { return vec2i(0, 0) - *this; }
+    inline vec2i &operator+=(const vec2i &other) { return *this = *this + other; }
+    inline vec2i operator*(int8_t factor) const { return vec2i(x * factor, y * factor); }
 
-    inline vec2i operator-(const vec2i &other) const { return {x - other.x, y - other.y}; }
-    inline vec2i operator-() const { return {-x, -y}; }
-    inline vec2i operator*(const vec2i &other) const { return {x * other.x, y * other.y}; }
-    inline vec2i operator*(int other) const { return {x * other, y * other}; }
-    inline vec2i operator*(float other) const { return {x * other, y * other}; }
-    inline vec2i operator/(const vec2i &other) const { return {x / other.x, y / other.y}; }
+    // Saturating (clamped to -128..127 per component)
+    inline vec2i AddSat(const vec2i &other) const { return vec2i(Saturate(x + other.x), Saturate(y + other.y)); }
 
-    inline bool operator==(const vec2i &other) const { return x == other.x && y == other.y; }
-    inline bool operator!=(const vec2i &other) const { return !(*this == other); }
-};
+    inline bool operator==(const vec2i &other) const { return word == other.word; }
+    inline bool operator!=(const vec2i &other) const { return word != other.word; }
 
-// Euclidean distance
-static inline float distance(const vec2i &a, const vec2i &b)
-{
-    return sqrt(pow(a.x - b.x, 2.f) + pow(a.y - b.y, 2.f));
-}
+private:
+    static inline int8_t Saturate(int value) { return value < -128 ? -128 : value > 127 ? 127 : value; }
+};
 
-// Check if a point (p) is between the line composed by a and b points
-static inline bool pointBetween(const vec2i &p, const vec2i &a, const vec2i &b)
+// World coordinates (see World in Game.h)
+struct vec2w
 {
-    return distance(a, p) + distance(b, p) == distance(a, b);
-}
+    int16_t x, y;
 
+    inline vec2w operator+(const vec2w &other) const { return {x + other.x, y + other.y}; }
+    inline vec2w operator+(const vec2i &step) const { return {x + step.x, y + step.y}; }
+    inline vec2w operator-(const vec2w &other) const { return {x - other.x, y - other.y}; }
 
-// Check if a point (p) is inside a rectangle
-static inline bool inside(const vec2i &p, const vec2i &pBBox, int widthBBox, int heightBBox)
-{
-    return p.x >= pBBox.x && p.x < pBBox.x + widthBBox && p.y >= pBBox.y && p.y < pBBox.y + heightBBox;
-}
+    inline bool operator==(const vec2w &other) const { return x == other.x && y == other.y; }
+    inline bool operator!=(const vec2w &other) const { return !(*this == other); }
+};
 
 #endif
@@ -0,0 +1,58 @@
+#include "Memory.h"
+
+#ifdef __AVR__
+
+// Byte used to paint the free memory at boot
+#define STACK_CANARY 0xC5
+
+// Symbols defined by the avr-libc linker script and malloc
+extern uint8_t _end;
+extern uint8_t __stack;
+extern uint8_t __heap_start;
+extern char *__brkval;
+
+// Paint everything between the end of .bss and the top of the stack before main() runs.
+// It lives in .init1, where there is no stack and r1 is not yet zero, so it's written in asm
+void PaintStack() __attribute__((naked, used, section(".init1")));
+void PaintStack()
+{
+    __asm volatile("    ldi r30, lo8(_end)\n"
+                   "    ldi r31, hi8(_end)\n"
+                   "    ldi r24, %0\n"
+                   "    ldi r25, hi8(__stack)\n"
+                   "    rjmp 2f\n"
+                   "1:\n"
+                   "    st Z+, r24\n"
+                   "2:\n"
+                   "    cpi r30, lo8(__stack)\n"
+                   "    cpc r31, r25\n"
+                   "    brlo 1b\n"
+                   "    breq 1b\n" ::"i"(STACK_CANARY));
+}
+
+static inline uint8_t *HeapTop()
+{
+    return __brkval == 0 ? &__heap_start : reinterpret_cast<uint8_t *>(__brkval);
+}
+
+int FreeMemory()
+{
+    uint8_t top;
+    return &top - HeapTop();
+}
+
+int UnusedStack()
+{
+    // Walk up from the heap top until the first byte the stack has overwritten
+    const uint8_t *p = HeapTop();
+    while (p <= &__stack && *p == STACK_CANARY)
+        ++p;
+    return p - HeapTop();
+}
+
+#else
+
+int FreeMemory() { return 0; }
+int UnusedStack() { return 0; }
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+/*
+    SRAM instrumentation.
+    The ATmega328P has only 2KB of SRAM shared between globals (.data/.bss), heap (List, String)
+    and stack, and nothing warns us when they collide. So:
+        - at boot the whole free area is "painted" with a known byte (stack painting)
+        - at run time we can read the current free memory and how deep the stack ever went
+          (both are sent to the host with the Serial link counters, see Protocol.h)
+        - at compile time the biggest objects are checked against a size budget
+*/
+
+#include "Arduino.h"
+
+// SRAM budgets (in bytes) of the biggest objects, checked at compile time on the target
+#define MENU_SIZE_BUDGET 12 // game titles are in flash (see Menu.cpp)
+#define SNAKE_GAME_SIZE_BUDGET 99 // 62 of them for the obstacle tiles (see Level.h)
+#define PONG_GAME_SIZE_BUDGET 27
+
+// Sizes only make sense for the AVR target (pointers and size_t are wider on other platforms)
+#ifdef __AVR__
+#define CHECK_SIZE_BUDGET(type, budget) static_assert(sizeof(type) <= (budget), #type " exceeds its SRAM budget")
+#else
+#define CHECK_SIZE_BUDGET(type, budget)
+#endif
+
+// Bytes currently free between heap top and stack pointer
+int FreeMemory();
+
+// Bytes of painted memory never touched by the stack (the stack high-water mark seen from below)
+int UnusedStack();
+
+#endif
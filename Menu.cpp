@@ -2,80 +2,195 @@
 #include "Menu.h"
 #include "Util.h"
 #include "Math.h"
+#if GAME_SNAKE
 #include "Snake.h"
+#endif
+#if GAME_PONG
 #include "Pong.h"
+#endif
+#include "Memory.h"
+#include "Profile.h"
+
+CHECK_SIZE_BUDGET(Menu, MENU_SIZE_BUDGET);
+
+template <class G>
+static Game *CreateGame(uint16_t seed) { return new G(seed); }
+
+// Games compiled in, in menu order
+#if GAME_SNAKE
+static const char SNAKE_TITLE[] PROGMEM = "Snake";
+#endif
+#if GAME_PONG
+static const char PONG_TITLE[] PROGMEM = "Pong";
+#endif
+static const GameEntry GAMES[NUMBER_OF_GAMES] PROGMEM = {
+#if GAME_SNAKE
+    {GameId::SNAKE, SNAKE_TITLE, CreateGame<SnakeGame<SnakeWorld>>},
+#endif
+#if GAME_PONG
+    {GameId::PONG, PONG_TITLE, CreateGame<PongGame<PongMap>>},
+#endif
+};
+
+static GameEntry GetEntry(uint8_t index)
+{
+    GameEntry entry;
+    memcpy_P(&entry, &GAMES[index], sizeof(entry));
+    return entry;
+}
 
 // Set current state to PLAYING (it means we're currently using menu)
 Menu::Menu() : Game(GameState::PLAYING), mSelectedGame(0)
 {
-    // Available game titles
-    mTitles[0] = "Snake";
-    mTitles[1] = "Pong";
 }
 
 /* 
-    This function is called in loop()
-    It takes as argument an int input; input is the IR signal received.
+    This function is called in loop() for every key received.
     This function, works as a state machine (states define in GameState structure)
 */
-void Menu::Update(int input)
+void Menu::OnKey(Key key)
 {
     if (mState == GameState::PLAYING)
     {       
-        switch (input)
+        Invalidate();
+        switch (key)
         {
         // move up the "<" cursor
-        case UP_KEY:
+        case Key::UP:
             mSelectedGame = posmod(--mSelectedGame, NUMBER_OF_GAMES);
-            if(gSpeakerOn) musicPlayer.beep(10);
+            Beep();
             break;
-        // analog to UP_KEY case
-        case DOWN_KEY:
+        // analog to Key::UP case
+        case Key::DOWN:
             mSelectedGame = posmod(++mSelectedGame, NUMBER_OF_GAMES);
-            if(gSpeakerOn) musicPlayer.beep(10);
+            Beep();
             break;
         // play selected game
-        case PLAY_PAUSE_KEY:
-            if(gSpeakerOn) musicPlayer.beep(10);
-            if (mGame != NULL)
-                delete mGame;
-            
-            if (mSelectedGame == 0) // snake
-                mGame = new SnakeGame(snakeMap);
-            else if (mSelectedGame == 1)        
-                mGame = new PongGame(snakeMap); 
-            // Pause menu and start selected game
-            mState = GameState::PAUSE;
+        case Key::PLAY_PAUSE:
+            Beep();
+            // A new game replaces the saved one
+            ClearSnapshot();
+            StartGame(mSelectedGame);
+            break;
+        default:
             break;
         }
-        Draw();
     }
     else if (mState == GameState::PAUSE)
     {
-        mGame->Update(input);
-        if (mGame->GetState() == GameState::GO_MENU)
-            mState = GameState::PLAYING;
+        const GameState previousState = mGame->GetState();
+        mGame->OnKey(key);
+        Supervise(previousState);
+    }
+}
+
+// Only the game being played moves with time, the menu screen is static
+void Menu::Tick()
+{
+    if (mState == GameState::PAUSE)
+    {
+        const GameState previousState = mGame->GetState();
+        mGame->Tick();
+        Supervise(previousState);
+    }
+}
+
+void Menu::Render()
+{
+    PROFILE_SCOPE(FRAME);
+    if (mState == GameState::PAUSE)
+        mGame->Render();
+    else
+        Game::Render();
+}
+
+// Follow the state changes of the game played after one of its events
+void Menu::Supervise(GameState previousState)
+{
+    const GameState state = mGame->GetState();
+
+    // Game paused or quit (Key::POWER) ==> save it, so it can be resumed after power loss
+    if (previousState == GameState::PLAYING && (state == GameState::PAUSE || state == GameState::GO_MENU))
+    {
+        SnapshotWriter writer;
+        mGame->Save(writer);
+        writer.Commit(GetPlayingId());
+    }
+    // Nothing to resume from a finished game
+    else if (previousState != GameState::FINISHED && state == GameState::FINISHED)
+        ClearSnapshot();
+
+    // Back to the menu, which has to be drawn again
+    if (state == GameState::GO_MENU)
+    {
+        mState = GameState::PLAYING;
+        Invalidate();
+    }
+}
+
+// Pause menu and start the game number `game`
+void Menu::StartGame(uint8_t game)
+{
+    if (mGame != NULL)
+        delete mGame;
+
+    mSelectedGame = game;
+    mGame = GetEntry(game).create(NextGameSeed());
+    mState = GameState::PAUSE;
+}
+
+GameId Menu::GetPlayingId() const { return GetEntry(mSelectedGame).id; }
+
+bool Menu::Resume()
+{
+    SnapshotReader reader;
+    if (!reader.IsValid())
+        return false;
+    // The saved game may not be compiled in this firmware
+    for (uint8_t game = 0; game < NUMBER_OF_GAMES; ++game)
+    {
+        if (GetEntry(game).id == reader.GetGameId())
+        {
+            StartGame(game);
+            mGame->Load(reader);
+            return true;
+        }
     }
+    return false;
+}
+
+// | MENU | state | selected game | while on menu, otherwise the state of the game being played
+uint8_t Menu::WriteState(uint8_t *buffer) const
+{
+    if (mState == GameState::PAUSE)
+        return mGame->WriteState(buffer);
+
+    buffer[0] = static_cast<uint8_t>(GameId::MENU);
+    buffer[1] = static_cast<uint8_t>(mState);
+    buffer[2] = mSelectedGame;
+    return 3;
 }
 
-void Menu::Draw()
+void Menu::Draw() const
 {
     u8g2.firstPage();
     do
     {
+        u8g2.setFont(FONT_TEXT);
         u8g2.setCursor(20, 13);
         u8g2.print(F("Choose a game:"));
         // Draw the menu
         for (uint8_t i = 0; i < NUMBER_OF_GAMES; ++i)
         {
             u8g2.setCursor(20, 13 * (i + 2));
+            const __FlashStringHelper *title = reinterpret_cast<const __FlashStringHelper *>(GetEntry(i).title);
             // If it's the game pointed by cursor (i.e. mSelectedGame) draw also " <" pointer near game name
             if (i == mSelectedGame)
             {
-                u8g2.print(mTitles[i]);
+                u8g2.print(title);
                 u8g2.print(F(" <"));
             }
-            else u8g2.print(mTitles[i]);
+            else u8g2.print(title);
         }
-    } while (u8g2.nextPage());
+    } while (NextPage());
 }
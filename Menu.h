@@ -3,21 +3,42 @@
 
 #include "Game.h"
 
-// Number of games available
-#define NUMBER_OF_GAMES 2
+// Number of games compiled in (see GAME_SNAKE and GAME_PONG in Util.h)
+#define NUMBER_OF_GAMES (GAME_SNAKE + GAME_PONG)
+static_assert(NUMBER_OF_GAMES > 0, "At least one game must be compiled in");
+
+// A game of the menu (registered in Menu.cpp): its identifier, title (PROGMEM) and how to start it
+struct GameEntry
+{
+    GameId id;
+    const char *title;
+    Game *(*create)(uint16_t seed);
+};
 
 class Menu : public Game
 {
 public:
     Menu();
-    void Update(int input) override;
+    void OnKey(Key key) override;
+    void Tick() override;
+    uint8_t WriteState(uint8_t *buffer) const override;
+    // The menu screen only changes with keys, otherwise ask the playing game
+    inline bool IsIdle() const override { return mState == GameState::PLAYING || mGame->IsIdle(); }
+    // While a game is played, it's the one drawn
+    inline bool NeedsRender() const override { return mState == GameState::PLAYING ? Game::NeedsRender() : mGame->NeedsRender(); }
+    void Render() override;
+
+    // Resume the game saved in EEPROM, if any (returns false if there's nothing to resume)
+    bool Resume();
 
 private:
-    String mTitles[NUMBER_OF_GAMES];
     uint8_t mSelectedGame; // Currently selected game on menu (not necessary the one playing)
     Game *mGame;
     
-    void Draw();
+    void Draw() const override;
+    void StartGame(uint8_t game);
+    void Supervise(GameState previousState);
+    GameId GetPlayingId() const;
 };
 
 #endif
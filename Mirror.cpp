@@ -0,0 +1,82 @@
+#include "Mirror.h"
+#include "Game.h"
+#include "Protocol.h"
+
+#if SCREEN_MIRROR
+
+Mirror gMirror;
+
+// (count, value) pairs; returns 0 when it would not be smaller than the 8 raw bytes
+static uint8_t EncodeTile(const uint8_t *tile, uint8_t *out)
+{
+    uint8_t length = 0;
+    for (uint8_t i = 0; i < 8;)
+    {
+        uint8_t count = 1;
+        while (i + count < 8 && tile[i + count] == tile[i])
+            ++count;
+        if (length + 2 >= 8)
+            return 0;
+        out[length++] = count;
+        out[length++] = tile[i];
+        i += count;
+    }
+    return length;
+}
+
+Mirror::Mirror() : mFrame(0), mEnabled(false), mFullFrame(false) {}
+
+void Mirror::Enable(bool enabled)
+{
+    mEnabled = enabled;
+    // The viewer starts from scratch: what was sent before does not count
+    mFullFrame = enabled;
+}
+
+void Mirror::CapturePage()
+{
+    if (!mEnabled)
+        return;
+
+    const uint8_t *buffer = u8g2.getBufferPtr();
+    const uint8_t firstRow = u8g2.getBufferCurrTileRow();
+    const uint8_t rows = u8g2.getBufferTileHeight();
+
+    for (uint8_t row = 0; row < rows && firstRow + row < TILES_Y; ++row)
+    {
+        for (uint8_t column = 0; column < TILES_X; ++column)
+        {
+            const uint8_t *tile = buffer + (row * TILES_X + column) * 8;
+            const uint8_t index = (firstRow + row) * TILES_X + column;
+            if (!mKeys.Changed(index, tile) && !mFullFrame)
+                continue;
+
+            uint8_t *payload = gLink.Payload();
+            uint8_t length = EncodeTile(tile, payload + 1);
+            payload[0] = index;
+            if (length == 0)
+            {
+                payload[0] |= TILE_RAW_FLAG;
+                memcpy(payload + 1, tile, 8);
+                length = 8;
+            }
+            // Not sent: make sure it does not match next frame either
+            if (!gLink.Send(MessageType::MIRROR_TILE, length + 1))
+                mKeys.Forget(index);
+        }
+    }
+}
+
+void Mirror::EndFrame()
+{
+    if (!mEnabled)
+        return;
+
+    // Rolling refresh, see TileKeys.h
+    mKeys.Refresh();
+    PutU16(gLink.Payload(), mFrame++);
+    gLink.Send(MessageType::MIRROR_SYNC, 2);
+    mFullFrame = false;
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef MIRROR_H
+#define MIRROR_H
+
+/*
+    Screen mirroring over the Serial link.
+    Every page buffer is captured right before u8g2 flushes it; the display is seen as 16x8 tiles
+    of 8x8 pixels and only tiles that changed since the last frame are sent (TileKeys.h, like the
+    display transfer), RLE compressed when it helps:
+        MIRROR_TILE payload: | tile index (bit 7 set = raw) | (count, value) pairs or 8 raw bytes |
+        MIRROR_SYNC payload: | frame number (uint16) |   sent after the last page of each frame
+    A tile that does not fit the TX buffer is forgotten, so it is simply sent again next frame.
+    Enabling the mirror sends the whole next frame, whatever was sent before.
+*/
+
+#include "Arduino.h"
+#include "Util.h"
+#include "TileKeys.h"
+
+#define TILE_RAW_FLAG 0x80
+
+class Mirror
+{
+public:
+    Mirror();
+
+    // Start sending frames (from scratch) or stop
+    void Enable(bool enabled);
+    inline bool IsEnabled() const { return mEnabled; }
+
+    // Send the changed tiles of the current page buffer; call it right before u8g2.nextPage()
+    void CapturePage();
+    // Call it once the last page of a frame has been flushed
+    void EndFrame();
+
+private:
+    TileKeys mKeys;
+    uint16_t mFrame;
+    bool mEnabled;
+    bool mFullFrame; // send every tile of the current frame
+};
+
+extern Mirror gMirror;
+
+#endif
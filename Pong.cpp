@@ -1,4 +1,11 @@
 #include "Pong.h"
+#include "Memory.h"
+#include "Profile.h"
+
+#if GAME_PONG
+
+// Every ball after the first one takes 6 more bytes
+CHECK_SIZE_BUDGET(PongGame<PongMap>, PONG_GAME_SIZE_BUDGET + 6 * (PONG_BALLS - 1));
 
 /* 
     Paddle object constructor;
@@ -14,218 +21,352 @@ void Paddle::Move(bool up)
     mPosition = mPosition + vec2i{0, up ? -1 : 1} * mSpeed;
 }
 
-void Paddle::Draw()
+void Paddle::Draw(DisplayList &list) const
 {
-    u8g2.drawBox(mPosition.x, mPosition.y, PADDLE_WIDTH, PADDLE_HEIGHT);
+    list.Box(mPosition.x, mPosition.y, PADDLE_WIDTH, PADDLE_HEIGHT);
 }
 
-Ball::Ball(const vec2i &position) : mPosition(position),
-                                    mDirection(GetRandomDirection()),
-                                    mSpeed(1),
-                                    mBounces(0)
+template <uint8_t N>
+void Balls<N>::Add(const vec2i &position, const vec2i &direction)
 {
+    if (mCount == N)
+        return;
+    mPositions[mCount] = position;
+    mDirections[mCount] = direction;
+    mSpeeds[mCount] = 1;
+    mBounces[mCount] = 0;
+    mCount++;
 }
 
-/*
-    Moves the ball also taking into account collisions;
-    Takes as argument:
-        - The game map
-        - Player paddle object
-        - Bot paddle object
-    return false if by moving the ball hits on of the two vertical walls otherwise true
-*/
-bool Ball::Move(const Map &pongMap, const Paddle &playerPaddle, const Paddle &botPaddle)
+// Order does not matter: the last ball takes the place of the removed one
+template <uint8_t N>
+void Balls<N>::Remove(uint8_t i)
 {
-    mPosition = mPosition + mDirection * mSpeed;
-
-    // Check if the ball hit top or bottom of the map, is so ==> bounce (vertical)
-    if (mPosition.y <= pongMap.pos.y || mPosition.y >= pongMap.pos.y + pongMap.height)
-        mDirection.y = -mDirection.y;
+    mCount--;
+    mPositions[i] = mPositions[mCount];
+    mDirections[i] = mDirections[mCount];
+    mSpeeds[i] = mSpeeds[mCount];
+    mBounces[i] = mBounces[mCount];
+}
 
-    // Check if the ball hit one of the two paddles, if so ==> bounce (horizontal)
-    else if (CollidePaddle(playerPaddle) || CollidePaddle(botPaddle))
+template <uint8_t N>
+template <class M>
+void Balls<N>::Move(const Paddle &left, const Paddle &right, uint8_t &leftOut, uint8_t &rightOut)
+{
+    PROFILE_SCOPE(PONG_MOVE);
+    bool bounced = false;
+    for (uint8_t i = 0; i < mCount;)
     {
-        if(gSpeakerOn) musicPlayer.beep(10);
-        mDirection.x = -mDirection.x;
-        // Every 3 bounces increase speed
-        if (++mBounces % 3 == 0)
-            this->IncreaseSpeed();
+        vec2i &position = mPositions[i];
+        vec2i &direction = mDirections[i];
+        // Saturating: a fast ball must not wrap around the screen before it's seen leaving the map
+        position = position.AddSat(direction * mSpeeds[i]);
+
+        // Check if the ball hit top or bottom of the map, is so ==> bounce (vertical)
+        if (position.y <= M::y || position.y >= M::bottom)
+            direction.y = -direction.y;
+
+        // Check if the ball hit a paddle, if so ==> bounce (horizontal).
+        // Paddles are sorted by x: only the one on the ball's half of the map can be hit
+        else if (Collide(position, position.x < M::centerX ? left : right))
+        {
+            bounced = true;
+            direction.x = -direction.x;
+            // Every 3 bounces increase speed
+            if (++mBounces[i] % 3 == 0)
+                mSpeeds[i]++;
+        }
+
+        // Check if ball hit left or right of the map, if so ==> it's out
+        if (position.x <= M::x || position.x >= M::right)
+        {
+            if (position.x < M::centerX)
+                leftOut++;
+            else
+                rightOut++;
+            Remove(i);
+        }
+        else
+            ++i;
     }
+    if (bounced) Beep();
+}
 
-    // Check if ball hit left or right of the map, if so ==> increase point state
-    if (mPosition.x <= pongMap.pos.x || mPosition.x >= pongMap.pos.x + pongMap.width)
-        return false;
-    
-    return true;
+template <uint8_t N>
+void Balls<N>::Draw(DisplayList &list) const
+{
+    for (uint8_t i = 0; i < mCount; ++i)
+        list.Circle(mPositions[i].x, mPositions[i].y, BALL_RADIUS);
 }
 
-void Ball::Draw()
+template <uint8_t N>
+uint8_t Balls<N>::Nearest(int8_t x) const
 {
-    u8g2.drawCircle(mPosition.x, mPosition.y, BALL_RADIUS, U8G2_DRAW_ALL);
+    uint8_t nearest = N;
+    uint8_t nearestDistance = 255;
+    for (uint8_t i = 0; i < mCount; ++i)
+    {
+        const uint8_t distance = abs(mPositions[i].x - x);
+        if (distance < nearestDistance)
+        {
+            nearest = i;
+            nearestDistance = distance;
+        }
+    }
+    return nearest;
 }
 
 // Ball-Paddle collision
-bool Ball::CollidePaddle(const Paddle &paddle)
+template <uint8_t N>
+bool Balls<N>::Collide(const vec2i &position, const Paddle &paddle)
 {
     const vec2i &paddlePosition = paddle.GetPosition();
-    return (mPosition.x > paddlePosition.x && mPosition.x < paddlePosition.x + PADDLE_WIDTH) &&
-           (mPosition.y > paddlePosition.y && mPosition.y < paddlePosition.y + PADDLE_HEIGHT);
+    return (position.x > paddlePosition.x && position.x < paddlePosition.x + PADDLE_WIDTH) &&
+           (position.y > paddlePosition.y && position.y < paddlePosition.y + PADDLE_HEIGHT);
 }
 
-// Private method used for generating a random valid direction
-vec2i Ball::GetRandomDirection() const
+// | count | for every ball: x | y | direction x | direction y | speed | bounces |
+template <uint8_t N>
+void Balls<N>::Save(SnapshotWriter &writer) const
 {
-    vec2i randomDir = {0, 0};
-    do
+    writer.Put(mCount);
+    for (uint8_t i = 0; i < mCount; ++i)
     {
-        randomDir.x = random(-1, 2);
-    } while (randomDir.x == 0);
-    
-    do
+        writer.Put(mPositions[i].x);
+        writer.Put(mPositions[i].y);
+        writer.Put(mDirections[i].x);
+        writer.Put(mDirections[i].y);
+        writer.Put(mSpeeds[i]);
+        writer.Put(mBounces[i]);
+    }
+}
+
+template <uint8_t N>
+void Balls<N>::Load(SnapshotReader &reader)
+{
+    mCount = min(reader.Get(), N);
+    for (uint8_t i = 0; i < mCount; ++i)
     {
-        randomDir.y = random(-1, 2);
-    } while (randomDir.y == 0);
-    return randomDir;
+        mPositions[i].x = reader.Get();
+        mPositions[i].y = reader.Get();
+        mDirections[i].x = reader.Get();
+        mDirections[i].y = reader.Get();
+        mSpeeds[i] = reader.Get();
+        mBounces[i] = reader.Get();
+    }
 }
 
-PongGame::PongGame(const Map &pongMap) : Game(GameState::PLAYING),
-                                         mPongMap(pongMap),
-                                         mPlayerScore(0),
-                                         mBotScore(0),
-                                         mPlayer(GetInitialPosition(true), true),
-                                         mBot(GetInitialPosition(false), false),
-                                         mBall((pongMap.pos + vec2i{pongMap.width, pongMap.height}) / vec2i{2, 2})
+template <class M>
+PongGame<M>::PongGame(uint16_t seed) : Game(GameState::PLAYING),
+                          mRandom(seed, RandomStream::PONG_BALL),
+                          mPlayer(GetInitialPosition(true), true),
+                          mBot(GetInitialPosition(false), false),
+                          mPreviousMoveUp(false),
+                          mPlayerScore(0),
+                          mBotScore(0)
 {
+    ServeBalls();
 }
 
-void PongGame::Update(int input)
+template <class M>
+void PongGame<M>::OnKey(Key key)
 {
     if (mState == GameState::PLAYING)
     {
-        switch (input)
+        switch (key)
         {
         // move up
-        case UP_KEY:
+        case Key::UP:
             mPlayer.Move(true);
             mPreviousMoveUp = true;
+            Invalidate();
             break;
         // move down
-        case DOWN_KEY:
+        case Key::DOWN:
             mPlayer.Move(false);
             mPreviousMoveUp = false;
+            Invalidate();
             break;
         // pause the game
-        case PLAY_PAUSE_KEY:
+        case Key::PLAY_PAUSE:
             mState = GameState::PAUSE;
+            Invalidate();
             break;
         // Special input for handling "while keypressed" event (IR natively does not support this feature)
         // e.g.: if user is holding up key whe should move up until key is pressed
-        case 0xFFFFFF:
+        case Key::REPEAT:
             mPlayer.Move(mPreviousMoveUp);
+            Invalidate();
             break;
         // quit the game
-        case POWER_KEY:
+        case Key::POWER:
             mState = GameState::GO_MENU;
             break;
+        default:
+            break;
         }
-
-        MoveBotPaddle();
-        // If ball cant move it means that we have a collision on vertical walls ==> current match ended
-        if (!mBall.Move(mPongMap, mPlayer, mBot))
-            mState = GameState::MATCH_ENDED;
-        
-        Draw();
     }
     else if (mState == GameState::PAUSE)
     {
-        DrawPauseScreen();
-        if (input == PLAY_PAUSE_KEY)
+        if (key == Key::PLAY_PAUSE)
+        {
             mState = GameState::PLAYING;
+            Invalidate();
+        }
     }
-    // draw gameover/winning, and wait to press play to go on menu
+    // gameover/winning is on screen, wait to press play to go on menu
     else if (mState == GameState::FINISHED)
     {
-        if (mPlayerScore == MAX_SCORE_PONG) DrawYouWin(mPlayerScore);
-        else DrawGameOver(mPlayerScore);
-
-        if (input == PLAY_PAUSE_KEY)
+        if (key == Key::PLAY_PAUSE)
             mState = GameState::GO_MENU;
     }
-    else if (mState == GameState::MATCH_ENDED)
+}
+
+template <class M>
+void PongGame<M>::Tick()
+{
+    if (mState == GameState::PLAYING)
     {
-        // If ball is on left side ==> increase player score
-        if (mBall.GetPosition().x < (mPongMap.pos.x + (mPongMap.width / 2)))
-            mPlayerScore++;
-        else
-            mBotScore++;
+        MoveBotPaddle();
+        // A ball out on the left side is a point for the player, on the right side for the bot
+        mBalls.template Move<M>(mBot, mPlayer, mPlayerScore, mBotScore);
+        // No ball left, or someone won ==> current match ended
+        if (mBalls.GetCount() == 0 || mPlayerScore >= MAX_SCORE_PONG || mBotScore >= MAX_SCORE_PONG)
+            mState = GameState::MATCH_ENDED;
 
+        // The balls move every tick
+        Invalidate();
+    }
+    else if (mState == GameState::MATCH_ENDED)
+    {
         // win or lose ==> end game
-        if (mPlayerScore == MAX_SCORE_PONG || mBotScore == MAX_SCORE_PONG)
+        if (mPlayerScore >= MAX_SCORE_PONG || mBotScore >= MAX_SCORE_PONG)
             mState = GameState::FINISHED;
         else
         {
             RestartGame();
             mState = GameState::PLAYING;
         }
+        Invalidate();
     }
 }
 
-void PongGame::Draw() const
+// | PONG | state | ball x | ball y | player paddle y | bot paddle y | player score | bot score | balls |
+// (ball is the first one, 0, 0 if there's none)
+template <class M>
+uint8_t PongGame<M>::WriteState(uint8_t *buffer) const
 {
-    u8g2.firstPage(); 
-    do
-    {
-        // Draw the map frame
-        u8g2.drawFrame(mPongMap.pos.x, mPongMap.pos.y, mPongMap.width, mPongMap.height);
+    const vec2i &ball = mBalls.GetCount() > 0 ? mBalls.GetPosition(0) : vec2i{0, 0};
+    buffer[0] = static_cast<uint8_t>(GameId::PONG);
+    buffer[1] = static_cast<uint8_t>(mState);
+    buffer[2] = ball.x;
+    buffer[3] = ball.y;
+    buffer[4] = mPlayer.GetPosition().y;
+    buffer[5] = mBot.GetPosition().y;
+    buffer[6] = mPlayerScore;
+    buffer[7] = mBotScore;
+    buffer[8] = mBalls.GetCount();
+    return 9;
+}
 
-        // Print player and bot scores
-        u8g2.setCursor(110, 13);
-        u8g2.print(mPlayerScore);
-        u8g2.setCursor(18, 13);
-        u8g2.print(mBotScore);
+// | balls | player x | player y | bot x | bot y | previous move up | player score | bot score | random state |
+template <class M>
+void PongGame<M>::Save(SnapshotWriter &writer) const
+{
+    mBalls.Save(writer);
+    writer.Put(mPlayer.GetPosition().x);
+    writer.Put(mPlayer.GetPosition().y);
+    writer.Put(mBot.GetPosition().x);
+    writer.Put(mBot.GetPosition().y);
+    writer.Put(mPreviousMoveUp);
+    writer.Put(mPlayerScore);
+    writer.Put(mBotScore);
+    writer.Put16(mRandom.GetState());
+}
 
-        // Draw ball and paddles
-        mBall.Draw();
-        mBot.Draw();
-        mPlayer.Draw();
-    } while (u8g2.nextPage());
+template <class M>
+void PongGame<M>::Load(SnapshotReader &reader)
+{
+    mBalls.Load(reader);
+    vec2i position;
+    position.x = reader.Get();
+    position.y = reader.Get();
+    mPlayer.SetPosition(position);
+    position.x = reader.Get();
+    position.y = reader.Get();
+    mBot.SetPosition(position);
+    mPreviousMoveUp = reader.Get();
+    mPlayerScore = reader.Get();
+    mBotScore = reader.Get();
+    mRandom.SetState(reader.Get16());
+    mState = GameState::PAUSE;
 }
 
-vec2i PongGame::GetInitialPosition(bool isPlayer) const
+template <class M>
+void PongGame<M>::Draw() const
 {
-    if (isPlayer)
+    if (mState == GameState::PAUSE)
+        DrawPauseScreen();
+    else if (mState == GameState::FINISHED)
     {
-        // Player position is 10 pixels before map's right wall for x axis
-        // And in the middle of the screen for y axis
-        vec2i playerPosition = (mPongMap.pos + vec2i{mPongMap.width, mPongMap.height});
-        playerPosition.y /= 2;
-        playerPosition.x -= 10;
-        return playerPosition;
+        if (mPlayerScore >= MAX_SCORE_PONG) DrawYouWin(mPlayerScore);
+        else DrawGameOver(mPlayerScore);
     }
+    // Playing, or last frame of a match
     else
+        DrawField();
+}
+
+template <class M>
+void PongGame<M>::DrawField() const
+{
+    PROFILE_SCOPE(PONG_DRAW);
+    // Game state is walked once, the display list is replayed for every page
+    gDisplayList.Render([this](DisplayList &list)
     {
-        // Analog to player paddle
-        vec2i botPosition = (mPongMap.pos + vec2i{0, mPongMap.height});
-        botPosition.y /= 2;
-        botPosition.x += 10;
-        return botPosition;
-    }
+        // Draw the map frame
+        M::DrawFrame(list);
+
+        // Print player and bot scores
+        list.Number(110, 13, mPlayerScore);
+        list.Number(18, 13, mBotScore);
+
+        // Draw balls and paddles
+        mBalls.Draw(list);
+        mBot.Draw(list);
+        mPlayer.Draw(list);
+    });
 }
 
-void PongGame::RestartGame()
+template <class M>
+void PongGame<M>::RestartGame()
 {
-    mBall = Ball((mPongMap.pos + vec2i{mPongMap.width, mPongMap.height}) / vec2i{2, 2});
+    ServeBalls();
 
     mPlayer = Paddle(GetInitialPosition(true), true);
     mBot = Paddle(GetInitialPosition(false), false);
 }
 
+template <class M>
+void PongGame<M>::ServeBalls()
+{
+    mBalls.Clear();
+    for (uint8_t i = 0; i < PONG_BALLS; ++i)
+        mBalls.Add(GetBallInitialPosition(i), GetRandomDirection());
+}
+
 // Mini AI that moves bot paddle according to ball position
 // It's not thought to always win
-void PongGame::MoveBotPaddle()
+template <class M>
+void PongGame<M>::MoveBotPaddle()
 {
+    // Follow the ball nearest to the bot
+    const uint8_t ball = mBalls.Nearest(mBot.GetPosition().x);
+    if (ball == PONG_BALLS)
+        return;
+
     // Take ball and bot positions (for bot we take the center of the paddle as reference position)
-    const vec2i &ballPosition = mBall.GetPosition();
+    const vec2i &ballPosition = mBalls.GetPosition(ball);
     const vec2i &botPosition = mBot.GetPosition() + vec2i{0, PADDLE_HEIGHT / 2};
 
     short botToBall = ballPosition.y - botPosition.y;
@@ -236,3 +377,10 @@ void PongGame::MoveBotPaddle()
     else if (botToBall > 0)
         mBot.Move(false); // Move down
 }
+
+template class PongGame<PongMap>;
+// The balls of the game are also moved on their own by the host benchmark (test/PongBench.cpp)
+template class Balls<PONG_BALLS>;
+template void Balls<PONG_BALLS>::Move<PongMap>(const Paddle &left, const Paddle &right, uint8_t &leftOut, uint8_t &rightOut);
+
+#endif
@@ -2,6 +2,7 @@
 #define PONG_H
 
 #include "Game.h"
+#include "Random.h"
 
 // Pong max score for a game
 #define MAX_SCORE_PONG (uint8_t)5
@@ -16,9 +17,10 @@ class Paddle
 public:
     Paddle(const vec2i &position, bool isPlayer);
     void Move(bool up);
-    void Draw();
+    void Draw(DisplayList &list) const;
     inline bool IsPlayer() const { return mIsPlayer; }
     inline vec2i GetPosition() const { return mPosition; }
+    inline void SetPosition(const vec2i &position) { mPosition = position; }
 
 private:
     vec2i mPosition;
@@ -28,43 +30,102 @@ private:
 
 #define BALL_RADIUS (uint8_t)2
 
-class Ball
+// Balls served at the start of every match (more than 1 ==> multi-ball Pong)
+#ifndef PONG_BALLS
+#define PONG_BALLS 1
+#endif
+
+/*
+    All the balls of a match, as parallel arrays (structure of arrays) instead of one object per ball:
+    moving them is a single loop over positions and directions, and a ball costs 6 bytes of SRAM.
+    Every ball has the same size (BALL_RADIUS).
+*/
+template <uint8_t N>
+class Balls
 {
 public:
-    Ball(const vec2i &position);
-    inline vec2i GetPosition() const { return mPosition; }
-    inline void IncreaseSpeed() { mSpeed += 1; }
-    bool Move(const Map &pongMap, const Paddle &playerPaddle, const Paddle &botPaddle);
-    void Draw();
-    bool CollidePaddle(const Paddle &paddle);
+    Balls() : mCount(0) {}
+    inline uint8_t GetCount() const { return mCount; }
+    inline vec2i GetPosition(uint8_t i) const { return mPositions[i]; }
+    inline void Clear() { mCount = 0; }
+    void Add(const vec2i &position, const vec2i &direction);
+
+    /*
+        Move every ball, bouncing on the top/bottom walls and on the paddles of map M (left paddle must
+        be left of the map center, right paddle right of it).
+        Balls leaving the map are removed and counted in leftOut/rightOut (by wall)
+    */
+    template <class M>
+    void Move(const Paddle &left, const Paddle &right, uint8_t &leftOut, uint8_t &rightOut);
+    void Draw(DisplayList &list) const;
+    // Index of the ball with the nearest x, N if there's no ball
+    uint8_t Nearest(int8_t x) const;
+    void Save(SnapshotWriter &writer) const;
+    void Load(SnapshotReader &reader);
 
 private:
-    vec2i mPosition;
-    vec2i mDirection;
-    uint8_t mSpeed;
-    uint8_t mBounces;
-    vec2i GetRandomDirection() const;
+    vec2i mPositions[N];
+    vec2i mDirections[N];
+    uint8_t mSpeeds[N];
+    uint8_t mBounces[N];
+    uint8_t mCount;
+
+    void Remove(uint8_t i);
+    static bool Collide(const vec2i &position, const Paddle &paddle);
 };
 
+// Paddles distance from the vertical walls
+#define PADDLE_OFFSET (uint8_t)10
+
+template <class M>
 class PongGame : public Game
 {
+    static_assert(M::width > 2 * (PADDLE_OFFSET + PADDLE_WIDTH), "Paddles do not fit the map");
+    static_assert(M::height > PADDLE_HEIGHT, "Paddles are taller than the map");
+
 public:
-    PongGame(const Map &pongMap);
-    void Update(int input) override;
+    PongGame(uint16_t seed);
+    void OnKey(Key key) override;
+    void Tick() override;
+    uint8_t WriteState(uint8_t *buffer) const override;
+    void Save(SnapshotWriter &writer) const override;
+    void Load(SnapshotReader &reader) override;
 
 private:
-    Map mPongMap;
+    Random mRandom;
     Paddle mPlayer;
     Paddle mBot;
-    Ball mBall;
+    Balls<PONG_BALLS> mBalls;
     bool mPreviousMoveUp; // Previous player move in previous frame
     uint8_t mPlayerScore;
     uint8_t mBotScore;
 
-    void Draw() const;
-    vec2i GetInitialPosition(bool isPlayer) const;
+    void Draw() const override;
+    void DrawField() const;
     void RestartGame();
+    void ServeBalls();
     void MoveBotPaddle();
+    // Random diagonal direction: no zero component to reject, one draw per axis
+    inline vec2i GetRandomDirection() { return vec2i{mRandom.Sign(), mRandom.Sign()}; }
+
+    /*
+        Start positions are around half the bottom-right corner of the map (the middle of the
+        screen, 1 pixel up and left of the map center with its 2 pixels margin).
+        Paddles start PADDLE_OFFSET pixels away from their wall.
+    */
+    static constexpr vec2i GetInitialPosition(bool isPlayer)
+    {
+        return isPlayer ? vec2i{M::right - PADDLE_OFFSET, M::bottom / 2} : vec2i{M::x + PADDLE_OFFSET, M::bottom / 2};
+    }
+    // Balls are served from there, spread evenly on the y axis
+    static constexpr vec2i GetBallInitialPosition(uint8_t i)
+    {
+        return vec2i{M::right / 2, M::bottom / 2 - (PONG_BALLS - 1 - 2 * i) * M::height / (2 * (PONG_BALLS + 1))};
+    }
 };
 
+// Instantiated in Pong.cpp
+extern template class PongGame<PongMap>;
+extern template class Balls<PONG_BALLS>;
+
 #endif
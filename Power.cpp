@@ -0,0 +1,29 @@
+#include "Power.h"
+#include "Util.h"
+
+DutyCycle gDutyCycle;
+
+#if defined(__AVR__) && IDLE_SLEEP
+
+#include <avr/sleep.h>
+
+void IdleSleep(unsigned long deadline, bool (*pending)())
+{
+    const unsigned long start = micros();
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    // An interrupt between the checks and sleep_cpu() only delays them to the next one (50us)
+    while (static_cast<long>(deadline - millis()) > 0 && !pending())
+    {
+        sleep_enable();
+        sleep_cpu();
+        sleep_disable();
+    }
+    gDutyCycle.sleepUs += micros() - start;
+    gDutyCycle.sleeps++;
+}
+
+#else
+
+void IdleSleep(unsigned long deadline, bool (*pending)()) {}
+
+#endif
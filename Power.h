@@ -0,0 +1,30 @@
+#ifndef POWER_H
+#define POWER_H
+
+/*
+    Idle sleep between game ticks.
+    When there is nothing to do until the next deadline (game tick, end of the welcome screen,
+    end of a beep), loop() puts the MCU in idle sleep instead of spinning: the CPU stops, timers,
+    TWI, USART and the IR receiver keep running, and any of their interrupts wakes it up.
+    The IR receiver samples its pin from a Timer2 interrupt every 50us, so the MCU wakes up about
+    20000 times a second: after each of these wakes it only checks the deadline and whether a key
+    came in (from the remote or the host) and goes back to sleep, loop() runs once per deadline
+    or key.
+    The time spent asleep is counted, the host reads the CPU duty cycle with GET_DUTY_CYCLE.
+*/
+
+#include "Arduino.h"
+
+struct DutyCycle
+{
+    uint32_t sleepUs; // time spent in idle sleep
+    uint16_t sleeps;  // number of times the MCU went to sleep until a deadline or a key
+};
+
+// Sleep until millis() reaches `deadline` or `pending()` is true, checked after every interrupt
+// (does nothing if IDLE_SLEEP is 0)
+void IdleSleep(unsigned long deadline, bool (*pending)());
+
+extern DutyCycle gDutyCycle;
+
+#endif
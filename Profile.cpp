@@ -0,0 +1,106 @@
+#include "Profile.h"
+
+#if PROFILE
+
+ProfileCounter gProfile[static_cast<uint8_t>(ProfileZone::COUNT)];
+
+#ifdef __AVR__
+
+// High 16 bits of the cycle counter, Timer1 being the low ones
+static volatile uint16_t sCyclesHigh;
+
+// Share of the CPU cycles taken by the periodic interrupts (1/65536)
+static uint16_t sInterruptLoad;
+
+ISR(TIMER1_OVF_vect)
+{
+    sCyclesHigh++;
+}
+
+uint32_t ProfileCycles()
+{
+    const uint8_t sreg = SREG;
+    cli();
+    uint16_t low = TCNT1;
+    uint16_t high = sCyclesHigh;
+    // Overflow not served yet (interrupts are off): the low part already wrapped
+    if ((TIFR1 & _BV(TOV1)) && low < 0x8000)
+        high++;
+    SREG = sreg;
+    return (uint32_t)high << 16 | low;
+}
+
+/*
+    Read the counter in a loop for PROFILE_CALIBRATION_CYCLES: the shortest gap between two reads
+    is the loop, anything longer is an interrupt. The time of the loop not spent in it is the
+    interrupt load.
+*/
+#define PROFILE_CALIBRATION_CYCLES (F_CPU / 50)
+
+static uint16_t MeasureInterruptLoad()
+{
+    const uint32_t start = ProfileCycles();
+    uint32_t last = start;
+    uint32_t shortest = 0xFFFFFFFF;
+    uint16_t reads = 0;
+    while (last - start < PROFILE_CALIBRATION_CYCLES)
+    {
+        const uint32_t now = ProfileCycles();
+        shortest = min(shortest, now - last);
+        last = now;
+        reads++;
+    }
+    const uint32_t interrupts = (last - start) - reads * shortest;
+    return (interrupts << 8) / ((last - start) >> 8);
+}
+
+void ProfileBegin()
+{
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10); // no prescaler: one tick per CPU cycle
+    TCNT1 = 0;
+    TIMSK1 = _BV(TOIE1);
+    sInterruptLoad = MeasureInterruptLoad();
+}
+
+static inline uint8_t SetMarker(uint8_t marker)
+{
+    const uint8_t previous = GPIOR0;
+    GPIOR0 = marker;
+    return previous;
+}
+
+// Cycles of a call without the share of the periodic interrupts
+static inline uint32_t WithoutInterrupts(uint32_t cycles)
+{
+    const uint32_t interrupts = (cycles >> 16) * sInterruptLoad + ((cycles & 0xFFFF) * sInterruptLoad >> 16);
+    return cycles - interrupts;
+}
+
+#else
+
+void ProfileBegin() {}
+uint32_t ProfileCycles() { return 0; }
+static inline uint8_t SetMarker(uint8_t marker) { return 0; }
+static inline uint32_t WithoutInterrupts(uint32_t cycles) { return cycles; }
+
+#endif
+
+ProfileScope::ProfileScope(ProfileZone zone) : mZone(zone)
+{
+    mPreviousMarker = SetMarker(static_cast<uint8_t>(zone) + 1);
+    mStart = ProfileCycles();
+}
+
+ProfileScope::~ProfileScope()
+{
+    uint32_t cycles = ProfileCycles() - mStart;
+    SetMarker(mPreviousMarker);
+    cycles = WithoutInterrupts(cycles);
+    ProfileCounter &counter = gProfile[static_cast<uint8_t>(mZone)];
+    counter.calls++;
+    counter.cycles += cycles;
+    counter.worst = max(counter.worst, cycles);
+}
+
+#endif
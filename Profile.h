@@ -0,0 +1,70 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+/*
+    Cycle counting of instrumented code (built only with PROFILE set to 1).
+    PROFILE_SCOPE(zone) at the top of a function counts its calls, total and worst CPU cycles
+    (Timer1 runs at the CPU clock, so Timer1 must not be used by anything else in profiling builds).
+    On entry the zone number + 1 is written to GPIOR0 and the previous value is restored on exit:
+    a simulator (e.g. simavr watching I/O writes) can time the zones from that register alone,
+    without the Serial link. The host reads the counts with GET_PROFILE.
+
+    The counts are approximate. Interrupts stay on in the zones (the display transfer needs
+    them), and the periodic ones (Timer0 for millis(), the IRremote Timer2 every 50us, the Timer1
+    overflow) steal cycles from them at a steady rate: ProfileBegin() measures that rate, and
+    the share of it is taken out of every call. What remains is the error of that average over
+    short calls (one ISR more or less), and the interrupts that are not periodic (Serial, TWI).
+    tools/simavr_bench.sh runs the firmware on simavr and counts the exact cycles of the same
+    zones from GPIOR0, interrupts included, to check them against.
+*/
+
+#include "Arduino.h"
+#include "Util.h"
+
+enum struct ProfileZone : uint8_t
+{
+    SNAKE_NEXT_MOVE, // Snake::GetNextMovementType
+    SNAKE_DRAW,      // SnakeGame::Draw, all pages
+    PONG_MOVE,       // Balls::Move
+    PONG_DRAW,       // PongGame::Draw, all pages
+    FRAME,           // Menu::Render: a whole frame, all pages sent
+    COUNT
+};
+
+struct ProfileCounter
+{
+    uint16_t calls;
+    uint32_t cycles; // total
+    uint32_t worst;  // longest call
+};
+
+#if PROFILE
+
+// Start the cycle counter (Timer1) and measure the interrupt load; call it once the periodic
+// interrupts run (after IRrecv::enableIRIn())
+void ProfileBegin();
+uint32_t ProfileCycles();
+
+class ProfileScope
+{
+public:
+    ProfileScope(ProfileZone zone);
+    ~ProfileScope();
+
+private:
+    uint32_t mStart;
+    ProfileZone mZone;
+    uint8_t mPreviousMarker;
+};
+
+extern ProfileCounter gProfile[static_cast<uint8_t>(ProfileZone::COUNT)];
+
+#define PROFILE_SCOPE(zone) ProfileScope profileScope(ProfileZone::zone)
+
+#else
+
+#define PROFILE_SCOPE(zone)
+
+#endif
+
+#endif
@@ -0,0 +1,220 @@
+#include "Protocol.h"
+#include "Util.h"
+#include "Memory.h"
+#include "Mirror.h"
+#include "DisplayTransfer.h"
+#include "Power.h"
+#include "DisplayList.h"
+#include "Profile.h"
+#include "Random.h"
+#include "Latency.h"
+
+#if FEATURE_SERIAL
+
+Link gLink;
+
+// CRC-8, polynomial 0x07
+static uint8_t Crc8(const uint8_t *data, uint8_t length)
+{
+    uint8_t crc = 0;
+    while (length--)
+    {
+        crc ^= *data++;
+        for (uint8_t bit = 0; bit < 8; ++bit)
+            crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
+
+Link::Link() : counters(), mRxCount(0), mTelemetry(false) {}
+
+void Link::Begin(unsigned long baud)
+{
+    Serial.begin(baud);
+}
+
+bool Link::Poll(unsigned long &key)
+{
+    while (Serial.available() > 0)
+    {
+        const uint8_t byte = Serial.read();
+
+        // Wait for the start of a frame
+        if (mRxCount == 0 && byte != FRAME_START)
+            continue;
+        // Payload too long ==> it's garbage, wait for the next frame
+        if (mRxCount == 2 && byte > FRAME_MAX_PAYLOAD)
+        {
+            counters.rxErrors++;
+            mRxCount = 0;
+            continue;
+        }
+
+        mRx[mRxCount++] = byte;
+        if (mRxCount >= FRAME_OVERHEAD && mRxCount == mRx[2] + FRAME_OVERHEAD)
+        {
+            mRxCount = 0;
+            if (Crc8(mRx + 1, mRx[2] + 2) != byte)
+                counters.rxErrors++;
+            else if (HandleFrame(key))
+                return true;
+        }
+    }
+    return false;
+}
+
+// Returns true if the frame was a key
+bool Link::HandleFrame(unsigned long &key)
+{
+    counters.rxFrames++;
+    const uint8_t *payload = mRx + FRAME_HEADER;
+    switch (static_cast<MessageType>(mRx[1]))
+    {
+    case MessageType::KEY:
+        if (mRx[2] != 4)
+            break;
+        key = GetU32(payload);
+        counters.serialKeys++;
+        return true;
+    case MessageType::TELEMETRY:
+        if (mRx[2] == 1)
+            mTelemetry = payload[0] != 0;
+        break;
+    case MessageType::GET_COUNTERS:
+        SendCounters();
+        break;
+    case MessageType::GET_DISPLAY:
+        SendDisplayStats();
+        break;
+    case MessageType::GET_DUTY_CYCLE:
+        SendDutyCycle();
+        break;
+    case MessageType::GET_FRAME_STATS:
+        SendFrameStats();
+        if (mRx[2] == 1 && payload[0] != 0)
+            gDisplayList.ResetWorst();
+        break;
+    case MessageType::GET_LATENCY:
+        SendLatency();
+        if (mRx[2] == 1 && payload[0] != 0)
+            gLatency.Reset();
+        break;
+#if PROFILE
+    case MessageType::GET_PROFILE:
+        SendProfile();
+        break;
+#endif
+    case MessageType::SEED:
+        if (mRx[2] == 2)
+            gRandomSeed = payload[0] | payload[1] << 8;
+        else if (mRx[2] == 0)
+            gRandomSeed = NoiseSeed(NOISE_PIN);
+        break;
+#if SCREEN_MIRROR
+    case MessageType::MIRROR:
+        if (mRx[2] == 1)
+            gMirror.Enable(payload[0] != 0);
+        break;
+#endif
+    default:
+        break;
+    }
+    return false;
+}
+
+void Link::SendCounters()
+{
+    uint8_t *p = Payload();
+    p = PutU16(p, counters.ticks);
+    p = PutU16(p, counters.irKeys);
+    p = PutU16(p, counters.serialKeys);
+    p = PutU16(p, counters.rxFrames);
+    p = PutU16(p, counters.rxErrors);
+    p = PutU16(p, counters.txDropped);
+    p = PutU16(p, FreeMemory());
+    p = PutU16(p, UnusedStack());
+    p = PutU16(p, counters.firstFrameMs);
+    p = PutU16(p, gGameSeed);
+    Send(MessageType::COUNTERS, p - Payload());
+}
+
+void Link::SendDisplayStats()
+{
+    uint8_t *p = Payload();
+    p = PutU32(p, gDisplayStats.bytes);
+    p = PutU16(p, gDisplayStats.transactions);
+    p = PutU16(p, gDisplayStats.tilesSent);
+    p = PutU16(p, gDisplayStats.tilesSkipped);
+    p = PutU32(p, gDisplayStats.waitUs);
+    p = PutU16(p, gDisplayStats.busErrors);
+    Send(MessageType::DISPLAY_STATS, p - Payload());
+}
+
+void Link::SendDutyCycle()
+{
+    uint8_t *p = Payload();
+    p = PutU32(p, micros());
+    p = PutU32(p, gDutyCycle.sleepUs);
+    p = PutU16(p, gDutyCycle.sleeps);
+    Send(MessageType::DUTY_CYCLE, p - Payload());
+}
+
+static uint8_t *PutFrameCost(uint8_t *p, const FrameCost &cost)
+{
+    *p++ = cost.commands;
+    return PutU16(p, cost.drawCalls);
+}
+
+void Link::SendFrameStats()
+{
+    uint8_t *p = Payload();
+    p = PutU16(p, gDisplayList.stats.frames);
+    p = PutU16(p, gDisplayList.stats.immediateFrames);
+    p = PutFrameCost(p, gDisplayList.stats.last);
+    p = PutFrameCost(p, gDisplayList.stats.worst);
+    Send(MessageType::FRAME_STATS, p - Payload());
+}
+
+void Link::SendLatency()
+{
+    uint8_t *p = Payload();
+    p = PutU16(p, gLatency.stats.keys);
+    p = PutU16(p, gLatency.stats.worstMs);
+    p = PutU32(p, gLatency.stats.totalMs);
+    for (uint8_t i = 0; i < LATENCY_BUCKETS; ++i)
+        p = PutU16(p, gLatency.stats.buckets[i]);
+    Send(MessageType::LATENCY, p - Payload());
+}
+
+#if PROFILE
+void Link::SendProfile()
+{
+    for (uint8_t zone = 0; zone < static_cast<uint8_t>(ProfileZone::COUNT); ++zone)
+    {
+        uint8_t *p = Payload();
+        *p++ = zone;
+        p = PutU16(p, gProfile[zone].calls);
+        p = PutU32(p, gProfile[zone].cycles);
+        p = PutU32(p, gProfile[zone].worst);
+        Send(MessageType::PROFILE_COUNTER, p - Payload());
+    }
+}
+#endif
+
+bool Link::Send(MessageType type, uint8_t length)
+{
+    // Never block the game: if the frame does not fit the TX buffer, drop it
+    if (Serial.availableForWrite() < length + FRAME_OVERHEAD)
+    {
+        counters.txDropped++;
+        return false;
+    }
+    mTx[0] = FRAME_START;
+    mTx[1] = static_cast<uint8_t>(type);
+    mTx[2] = length;
+    mTx[FRAME_HEADER + length] = Crc8(mTx + 1, length + 2);
+    Serial.write(mTx, length + FRAME_OVERHEAD);
+    return true;
+}
+
+#endif
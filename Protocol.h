@@ -0,0 +1,111 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+/*
+    Binary Serial protocol used to control the GamePad and read telemetry from a host.
+    Every frame is:
+        | 0xA5 | type | length | payload (length bytes) | crc8 |
+    crc8 (polynomial 0x07, initial value 0) covers type, length and payload.
+    Multi-byte fields are little endian.
+
+    Frames are built in place in fixed buffers (no String, no heap) and are dropped, never
+    waited for, when the Serial TX buffer is full.
+*/
+
+#include "Arduino.h"
+
+#define FRAME_START 0xA5
+#define FRAME_HEADER 3  // start, type, length
+#define FRAME_OVERHEAD 4 // header + crc
+#define FRAME_MAX_PAYLOAD 20
+
+// Message types (host -> device below 0x80, device -> host from 0x80)
+enum struct MessageType : uint8_t
+{
+    KEY          = 0x01, // uint32 IR code, handled exactly like a key from the remote
+    TELEMETRY    = 0x02, // uint8: 1 = send a STATE frame every tick, 0 = stop
+    GET_COUNTERS = 0x03, // no payload, answered with COUNTERS
+    MIRROR       = 0x04, // uint8: 1 = start screen mirroring from a full frame, 0 = stop (see Mirror.h)
+    GET_DISPLAY  = 0x05, // no payload, answered with DISPLAY_STATS
+    SEED         = 0x06, // uint16 seed of the next game, the following ones are derived from it (replay a game), empty = reseed from noise
+    GET_DUTY_CYCLE = 0x07, // no payload, answered with DUTY_CYCLE
+    GET_FRAME_STATS = 0x08, // optional uint8: 1 = reset the worst frame cost after answering. Answered with FRAME_STATS
+    GET_PROFILE  = 0x09, // no payload, answered with a PROFILE_COUNTER frame per zone (firmware built with PROFILE=1)
+    GET_LATENCY  = 0x0A, // optional uint8: 1 = reset the latency histogram after answering. Answered with LATENCY
+    STATE        = 0x81, // game state (see Game::WriteState)
+    COUNTERS     = 0x83, // Counters (except firstFrameMs), int16 free memory, int16 unused stack, uint16 firstFrameMs,
+                         // uint16 seed of the last game started
+    MIRROR_TILE  = 0x84, // one changed 8x8 tile of the screen
+    MIRROR_SYNC  = 0x85, // uint16 frame number, sent when a mirrored frame is complete
+    DISPLAY_STATS = 0x86, // DisplayStats (see DisplayTransfer.h)
+    DUTY_CYCLE   = 0x87, // uint32 micros(), DutyCycle (see Power.h): the host computes the duty cycle from two answers
+    FRAME_STATS  = 0x88, // FrameStats (see DisplayList.h): frames, immediate frames, last and worst FrameCost
+    PROFILE_COUNTER = 0x89, // uint8 ProfileZone, ProfileCounter (see Profile.h)
+    LATENCY      = 0x8A  // LatencyStats (see Latency.h): keys, worst and total ms, histogram buckets
+};
+
+struct Counters
+{
+    uint16_t ticks;      // game ticks (see GAME_TICK_MS)
+    uint16_t irKeys;     // keys received from the IR remote
+    uint16_t serialKeys; // keys received from the Serial link
+    uint16_t rxFrames;   // valid frames received
+    uint16_t rxErrors;   // frames discarded (bad length or checksum)
+    uint16_t txDropped;  // frames dropped because the TX buffer was full
+    uint16_t firstFrameMs; // time from reset to the first interactive frame
+};
+
+class Link
+{
+public:
+    Link();
+    void Begin(unsigned long baud);
+
+    // Parse the received bytes; returns true (leaving the rest unread) as soon as a KEY frame arrives
+    bool Poll(unsigned long &key);
+
+    // Zero-copy sending: write up to FRAME_MAX_PAYLOAD bytes in Payload(), then Send() them.
+    // Returns false if the frame has been dropped
+    inline uint8_t *Payload() { return mTx + FRAME_HEADER; }
+    bool Send(MessageType type, uint8_t length);
+
+    inline bool IsTelemetryOn() const { return mTelemetry; }
+
+    Counters counters;
+
+private:
+    uint8_t mRx[FRAME_MAX_PAYLOAD + FRAME_OVERHEAD];
+    uint8_t mTx[FRAME_MAX_PAYLOAD + FRAME_OVERHEAD];
+    uint8_t mRxCount;
+    bool mTelemetry;
+
+    bool HandleFrame(unsigned long &key);
+    void SendCounters();
+    void SendDisplayStats();
+    void SendDutyCycle();
+    void SendFrameStats();
+    void SendProfile();
+    void SendLatency();
+};
+
+// Little endian field writers/readers for payloads
+static inline uint8_t *PutU16(uint8_t *p, uint16_t value)
+{
+    p[0] = value;
+    p[1] = value >> 8;
+    return p + 2;
+}
+
+static inline uint8_t *PutU32(uint8_t *p, uint32_t value)
+{
+    return PutU16(PutU16(p, value), value >> 16);
+}
+
+static inline uint32_t GetU32(const uint8_t *p)
+{
+    return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+extern Link gLink;
+
+#endif
@@ -0,0 +1,20 @@
+#include "Random.h"
+
+uint16_t gRandomSeed = 1;
+uint16_t gGameSeed;
+
+uint16_t NextGameSeed()
+{
+    gGameSeed = gRandomSeed;
+    gRandomSeed = Random(gRandomSeed, RandomStream::GAME_SEED).Next();
+    return gGameSeed;
+}
+
+uint16_t NoiseSeed(uint8_t pin)
+{
+    // The LSB of a floating pin is noisy but biased: fold 16 reads with a rotate so every read touches every bit
+    uint16_t seed = 0;
+    for (uint8_t i = 0; i < 16; ++i)
+        seed = (seed << 3 | seed >> 13) ^ analogRead(pin);
+    return seed;
+}
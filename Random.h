@@ -0,0 +1,67 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+/*
+    Small, seedable pseudo random generator (16-bit xorshift, shifts 7/9/8).
+    Arduino random() keeps one global state and does a 32-bit division for every bounded draw;
+    here each game owns a stream per purpose, so a game is reproduced exactly from its seed and
+    one purpose (e.g. apples) never shifts the sequence of another one.
+    On AVR the 7/9/8 shifts are mostly byte moves, and bounded draws are a multiply and a shift.
+*/
+
+#include "Arduino.h"
+
+// Streams of the games: same master seed, independent sequences
+enum struct RandomStream : uint8_t
+{
+    SNAKE_APPLE = 1,
+    PONG_BALL = 2,
+    SNAKE_LEVEL = 3,
+    GAME_SEED = 4 // master sequence of the game seeds (see NextGameSeed)
+};
+
+class Random
+{
+public:
+    Random(uint16_t seed, RandomStream stream) { Seed(seed, stream); }
+
+    // Every seed gives its own sequence (xorshift must never be in the all zero state: that one
+    // seed per stream shares the sequence of its neighbour, see SetState)
+    inline void Seed(uint16_t seed, RandomStream stream) { SetState(seed ^ static_cast<uint8_t>(stream) * 0x9E37u); }
+
+    inline uint16_t Next()
+    {
+        mState ^= mState << 7;
+        mState ^= mState >> 9;
+        mState ^= mState << 8;
+        return mState;
+    }
+
+    // Uniform value in [0, range) without division nor retry loop (multiply-shift)
+    inline uint16_t Below(uint16_t range) { return (static_cast<uint32_t>(Next()) * range) >> 16; }
+
+    // -1 or 1, from the top bit (the best one of xorshift) without branching
+    inline int8_t Sign() { return static_cast<int8_t>(Next() >> 14 & 2) - 1; }
+
+    // The state is saved with the game snapshot, so a resumed game keeps its sequence
+    // (only a corrupted zero state is replaced, every other state is restored as it was)
+    inline uint16_t GetState() const { return mState; }
+    inline void SetState(uint16_t state) { mState = state != 0 ? state : 1; }
+
+private:
+    uint16_t mState;
+};
+
+// Master seed of the next game: analog noise at boot, or set by the host (Serial SEED message) to replay a game
+extern uint16_t gRandomSeed;
+// Seed of the last game started (reported to the host, which replays the game by sending it back with SEED)
+extern uint16_t gGameSeed;
+
+// Seed of a game being started: the master seed, which then moves on, so every game of a power
+// cycle is different (and a Snake level is drawn again for every game)
+uint16_t NextGameSeed();
+
+// Build a seed from the least significant bit of an unconnected analog pin
+uint16_t NoiseSeed(uint8_t pin);
+
+#endif
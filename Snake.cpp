@@ -1,7 +1,23 @@
 // Include header file
 #include "Snake.h"
+#include "Memory.h"
+#include "Profile.h"
 
-Snake::Snake(const vec2i &startPosition, const vec2i &startDirection) : mSpeed(1), mScore(0)
+#if GAME_SNAKE
+
+CHECK_SIZE_BUDGET(SnakeGame<SnakeWorld>, SNAKE_GAME_SIZE_BUDGET);
+static_assert(SNAKE_TURN_QUEUE <= 4, "Queued turns must fit one byte");
+
+// Unit steps are stored in 2 bits: right, left, down, up
+static const vec2i STEPS[4] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+static inline uint8_t StepCode(int16_t x, int16_t y)
+{
+    return x != 0 ? (x < 0) : 2 + (y < 0);
+}
+
+Snake::Snake(const vec2w &startPosition, const vec2i &startDirection, uint8_t rate) :
+    mTurns(0), mTurnCount(0), mRate(rate), mProgress(0), mScore(0)
 {
     mPositions.Add(startPosition);
     mDirection = startDirection;
@@ -9,163 +25,318 @@ Snake::Snake(const vec2i &startPosition, const vec2i &startDirection) : mSpeed(1
 
 void Snake::ChangeDirection(const vec2i &newDirection)
 {
-    // Check if is a valid change of direction
+    if (mTurnCount == SNAKE_TURN_QUEUE)
+        return;
+
+    // Check if is a valid change of direction, from the direction the snake will follow when it
+    // takes this turn (the last one queued)
     // e.g.: If snake is going right it cannot go left, otherwise it will eat himself causing gameover
-    if ((mDirection + newDirection) != vec2i{0, 0})
-        mDirection = newDirection;
+    const vec2i &direction = mTurnCount > 0 ? STEPS[mTurns >> (2 * (mTurnCount - 1)) & 3] : mDirection;
+    // Going on straight is not a turn, it would only delay the next ones
+    if ((direction + newDirection) == vec2i{0, 0} || direction == newDirection)
+        return;
+
+    mTurns |= StepCode(newDirection.x, newDirection.y) << (2 * mTurnCount);
+    mTurnCount++;
 }
 
-MoveType Snake::GetNextMovementType(const Apple &apple, const Map &snakeMap)
+void Snake::TakeTurn()
 {
-    const vec2i &nextPosition = GetNextPosition(snakeMap);
+    if (mTurnCount == 0)
+        return;
+    mDirection = STEPS[mTurns & 3];
+    mTurns >>= 2;
+    mTurnCount--;
+}
+
+MoveType Snake::GetNextMovementType(const Apple &apple)
+{
+    PROFILE_SCOPE(SNAKE_NEXT_MOVE);
+    const vec2w &nextPosition = GetNextPosition();
     
     if (apple.Collision(nextPosition))
         return MoveType::A;
 
-    // Check if outside the map
-    if (!inside(nextPosition, snakeMap.pos, snakeMap.width, snakeMap.height))
-        return MoveType::B;
-    
-    // For each snake's body part
-    for (int8_t i = 1; i < mPositions.Count(); ++i)
+    // Snake moves one cell per step so the body has no gaps and an exact cell check is enough.
+    // The tail is skipped: it will be freed by this same move
+    for (size_t i = 1; i + 1 < mPositions.Count(); ++i)
     {
         // body collision
         if (mPositions[i] == nextPosition)
             return MoveType::B;
-        // Fallback: same check but robust to floating point errors
-        if (pointBetween(nextPosition, mPositions[i], mPositions[i - 1]))
-            return MoveType::B;
     }
     return MoveType::E;
 }
 
-void Snake::Move(const Map &snakeMap)
+void Snake::Move()
 {
-    mPositions.Insert(GetNextPosition(snakeMap));
+    mPositions.Insert(GetNextPosition());
     mPositions.RemoveLast();
 }
 
-void Snake::Eat(const Apple &apple, const Map &snakeMap)
+void Snake::Eat()
 {
-    if(gSpeakerOn) musicPlayer.beep(10);
+    Beep();
     
     // Increase snake body
-    mPositions.Insert(GetNextPosition(snakeMap));
+    mPositions.Insert(GetNextPosition());
     
-    // Update score and speed based on score
+    // Update score and speed based on score (+1.5/16 cell per frame for each apple, from the level start speed)
     mScore++;
-    if (mScore > 10)
-        mSpeed = 2;
-    if (mScore > 20)
-        mSpeed = 3;
+    const uint8_t rate = mRate + 1 + !(mScore & 1);
+    mRate = rate > SNAKE_MAX_RATE ? SNAKE_MAX_RATE : rate;
 }
 
-
-void Snake::Draw() const
+/*
+    Snake moves one cell per step, so the body is stored as its head followed by the 2-bit step
+    between each pair of cells (4 cells per byte):
+    | score | rate | progress | direction | turns | turn count | length (uint16) | head x | head y | steps... |
+*/
+void Snake::Save(SnapshotWriter &writer) const
 {
-    for (uint8_t i = 0; i < mPositions.Count(); ++i)
+    writer.Put(mScore);
+    writer.Put(mRate);
+    writer.Put(mProgress);
+    writer.Put(StepCode(mDirection.x, mDirection.y));
+    writer.Put(mTurns);
+    writer.Put(mTurnCount);
+    writer.Put16(mPositions.Count());
+    writer.Put16(mPositions[0].x);
+    writer.Put16(mPositions[0].y);
+
+    uint8_t packed = 0;
+    for (size_t i = 1; i < mPositions.Count(); ++i)
     {
-        const vec2i &pos = mPositions[i];
-        u8g2.drawBox(pos.x, pos.y, BODY_SIZE, BODY_SIZE);
+        const vec2w &step = mPositions[i] - mPositions[i - 1];
+        packed |= StepCode(step.x, step.y) << (2 * (i % 4));
+        if (i % 4 == 3 || i + 1 == mPositions.Count())
+        {
+            writer.Put(packed);
+            packed = 0;
+        }
     }
 }
 
-// Construct an apple object at random location in the map
-Apple Apple::Spawn(const Map &snakeMap)
+void Snake::Load(SnapshotReader &reader)
 {
-    return Apple({static_cast<uint8_t>(random(snakeMap.pos.x, snakeMap.width - SIZE)), static_cast<uint8_t>(random(snakeMap.pos.y, snakeMap.height - SIZE))});
+    mScore = reader.Get();
+    mRate = reader.Get();
+    mProgress = reader.Get();
+    mDirection = STEPS[reader.Get() & 3];
+    mTurns = reader.Get();
+    mTurnCount = min(reader.Get(), SNAKE_TURN_QUEUE);
+    const uint16_t length = reader.Get16();
+    vec2w position;
+    position.x = reader.Get16();
+    position.y = reader.Get16();
+
+    mPositions.Clear();
+    mPositions.Add(position);
+    uint8_t packed = 0;
+    for (size_t i = 1; i < length; ++i)
+    {
+        if (i == 1 || i % 4 == 0)
+            packed = reader.Get();
+        position = position + STEPS[packed >> (2 * (i % 4)) & 3];
+        mPositions.Add(position);
+    }
 }
 
-Apple Apple::Spawn(const vec2i &position) { return Apple(position); }
+Apple Apple::Spawn(const vec2w &position) { return Apple(position); }
+
+static Snake StartSnake(const Level &level)
+{
+    return Snake({level.x, level.y}, {level.dx, level.dy}, level.rate);
+}
 
 // SNAKEGAME Implementation
-SnakeGame::SnakeGame(const Map &snakeMap) : 
+template <class W>
+SnakeGame<W>::SnakeGame(uint16_t seed) : 
     Game(GameState::PLAYING), 
-    mSnakeMap(snakeMap), 
-    mSnake(Snake({10, 10}, {1, 0})), 
-    mApple(Apple::Spawn(snakeMap))
+    mRandom(seed, RandomStream::SNAKE_APPLE),
+    mLevel(Random(seed, RandomStream::SNAKE_LEVEL).Below(GetLevelCount())),
+    mObstacles(GetLevel(mLevel).runs),
+    mSnake(StartSnake(GetLevel(mLevel))),
+    mApple(SpawnApple()),
+    mCamera(W::Follow(mSnake.GetHeadPosition()))
+{
+}
+
+// Apples are never put on an obstacle (levels leave most of the world free, a few draws are enough)
+template <class W>
+Apple SnakeGame<W>::SpawnApple()
 {
+    Apple apple = Apple::Spawn<W>(mRandom);
+    while (mObstacles.Overlaps(apple.GetPosition(), Apple::SIZE))
+        apple = Apple::Spawn<W>(mRandom);
+    return apple;
 }
 
 
-void SnakeGame::Update(int input)
+template <class W>
+void SnakeGame<W>::OnKey(Key key)
 {
     if (mState == GameState::PLAYING)
     {
-        switch (input)
+        switch (key)
         {
         // move left
-        case KEY_4: 
+        case Key::DIGIT_4:
             mSnake.ChangeDirection({-1, 0});
             break;
         // move up
-        case KEY_2:
+        case Key::DIGIT_2:
             mSnake.ChangeDirection({0, -1});
             break;
         // move down
-        case KEY_8: 
+        case Key::DIGIT_8:
             mSnake.ChangeDirection({0, 1});
             break;
         // move right
-        case KEY_6:
+        case Key::DIGIT_6:
             mSnake.ChangeDirection({1, 0});
             break;
         // pause game
-        case PLAY_PAUSE_KEY:
+        case Key::PLAY_PAUSE:
             mState = GameState::PAUSE;
+            Invalidate();
             break;
         // quit game and go menu
-        case POWER_KEY:
+        case Key::POWER:
             mState = GameState::GO_MENU;
             break;
-        }
-
-        switch (mSnake.GetNextMovementType(mApple, snakeMap))
-        {
-        case MoveType::E:
-            mSnake.Move(snakeMap);
-            break;
-        case MoveType::A:
-            mSnake.Eat(mApple, snakeMap);
-            mApple = Apple::Spawn(snakeMap);
-            break;
-        // If it's a collision ==> GAME OVER!!!!
-        case MoveType::B:
-            mState = GameState::FINISHED;
+        default:
             break;
         }
-
-        Draw();
     }
-
     else if (mState == GameState::PAUSE)
     {
-        DrawPauseScreen();
-        if (input == PLAY_PAUSE_KEY)
+        if (key == Key::PLAY_PAUSE)
+        {
             mState = GameState::PLAYING;
+            Invalidate();
+        }
     }
     else if (mState == GameState::FINISHED)
     {
-        DrawGameOver(mSnake.GetScore());
-        if (input == PLAY_PAUSE_KEY)
+        if (key == Key::PLAY_PAUSE)
             mState = GameState::GO_MENU;
     }
 }
 
-void SnakeGame::Draw() const
+template <class W>
+void SnakeGame<W>::Tick()
 {
-    u8g2.firstPage();
-    do
+    if (mState == GameState::PLAYING)
     {
-        // Draw map frame
-        u8g2.drawFrame(mSnakeMap.pos.x, mSnakeMap.pos.y, mSnakeMap.width, mSnakeMap.height);
+        // Move one cell at a time, so every sub-step gets its own apple and collision check
+        const uint8_t steps = mSnake.Advance();
+        for (uint8_t step = 0; step < steps && mState != GameState::FINISHED; ++step)
+        {
+            // One queued turn per cell
+            mSnake.TakeTurn();
+            // Check if outside the map or on an obstacle, otherwise ask the snake what's in the next cell
+            const vec2w &next = mSnake.GetNextPosition();
+            const MoveType moveType = W::Inside(next) && !mObstacles.Blocked(next) ? mSnake.GetNextMovementType(mApple) : MoveType::B;
+            switch (moveType)
+            {
+            case MoveType::E:
+                mSnake.Move();
+                break;
+            case MoveType::A:
+                mSnake.Eat();
+                mApple = SpawnApple();
+                break;
+            // If it's a collision ==> GAME OVER!!!!
+            case MoveType::B:
+                mState = GameState::FINISHED;
+                break;
+            }
+        }
+        // Nothing to draw again until the snake moves (at low speed not every tick)
+        if (steps > 0)
+        {
+            mCamera = W::Follow(mSnake.GetHeadPosition());
+            Invalidate();
+        }
+    }
+}
+
+// | SNAKE | state | head x (int16) | head y (int16) | length (uint16) | score | level |
+template <class W>
+uint8_t SnakeGame<W>::WriteState(uint8_t *buffer) const
+{
+    const vec2w &head = mSnake.GetHeadPosition();
+    buffer[0] = static_cast<uint8_t>(GameId::SNAKE);
+    buffer[1] = static_cast<uint8_t>(mState);
+    buffer[2] = head.x;
+    buffer[3] = head.x >> 8;
+    buffer[4] = head.y;
+    buffer[5] = head.y >> 8;
+    buffer[6] = mSnake.GetLength();
+    buffer[7] = mSnake.GetLength() >> 8;
+    buffer[8] = mSnake.GetScore();
+    buffer[9] = mLevel;
+    return 10;
+}
+
+// | snake | apple x | apple y | random state | level |
+template <class W>
+void SnakeGame<W>::Save(SnapshotWriter &writer) const
+{
+    mSnake.Save(writer);
+    writer.Put16(mApple.GetPosition().x);
+    writer.Put16(mApple.GetPosition().y);
+    writer.Put16(mRandom.GetState());
+    writer.Put(mLevel);
+}
+
+template <class W>
+void SnakeGame<W>::Load(SnapshotReader &reader)
+{
+    mSnake.Load(reader);
+    vec2w apple;
+    apple.x = reader.Get16();
+    apple.y = reader.Get16();
+    mApple = Apple::Spawn(apple);
+    mRandom.SetState(reader.Get16());
+    mLevel = reader.Get() % GetLevelCount();
+    mObstacles.Load(GetLevel(mLevel).runs);
+    mCamera = W::Follow(mSnake.GetHeadPosition());
+    mState = GameState::PAUSE;
+}
+
+template <class W>
+void SnakeGame<W>::Draw() const
+{
+    if (mState == GameState::PLAYING)
+        DrawField();
+    else if (mState == GameState::PAUSE)
+        DrawPauseScreen();
+    else if (mState == GameState::FINISHED)
+        DrawGameOver(mSnake.GetScore());
+}
+
+template <class W>
+void SnakeGame<W>::DrawField() const
+{
+    PROFILE_SCOPE(SNAKE_DRAW);
+    // Game state is walked once, the display list is replayed for every page
+    gDisplayList.Render([this](DisplayList &list)
+    {
+        // Draw the world walls and the obstacles in sight
+        W::DrawWalls(list, mCamera);
+        mObstacles.Draw(list, mCamera);
 
         // Draw score
-        u8g2.setCursor(110, 13);
-        u8g2.print(mSnake.GetScore());
+        list.Number(110, 13, mSnake.GetScore());
 
-        // Draw snake and the apple
-        mSnake.Draw();
-        mApple.Draw();
-    } while (u8g2.nextPage());
+        // Draw snake and the apple (both culled to the viewport)
+        mSnake.Draw<W>(list, mCamera);
+        mApple.Draw<W>(list, mCamera);
+    });
 }
+
+template class SnakeGame<SnakeWorld>;
+
+#endif
@@ -5,7 +5,14 @@
 #include "Math.h"
 #include "Util.h"
 #include "Game.h"
+#include "Random.h"
+#include "Level.h"
 
+// Snake speed is a fixed-point rate (4.4 format: 16 means one cell per frame)
+#define SNAKE_BASE_RATE (uint8_t)16
+#define SNAKE_MAX_RATE (uint8_t)48
+// Turns that can be queued before the snake moves (at most 4, they are packed in one byte)
+#define SNAKE_TURN_QUEUE 3
 
 // Define next move type
 enum struct MoveType
@@ -18,64 +25,126 @@ enum struct MoveType
 class Apple
 {
 public:
-    static Apple Spawn(const Map &snakeMap);
-    static Apple Spawn(const vec2i &position);
+    // Construct an apple object at random location fully inside the world W
+    template <class W>
+    static Apple Spawn(Random &random)
+    {
+        static_assert(W::width > SIZE && W::height > SIZE, "Apple does not fit the world");
+        return Apple({static_cast<int16_t>(random.Below(W::width - SIZE)), static_cast<int16_t>(random.Below(W::height - SIZE))});
+    }
+    static Apple Spawn(const vec2w &position);
+    static const uint8_t SIZE = 5;
     
-    inline vec2i GetPosition() const { return mPosition; }
-    inline void Draw() const { u8g2.drawBox(mPosition.x, mPosition.y, SIZE, SIZE); }
-    inline bool Collision(const vec2i &position) const { return inside(position, mPosition, SIZE, SIZE); }
+    inline vec2w GetPosition() const { return mPosition; }
+    inline bool Collision(const vec2w &position) const
+    {
+        return static_cast<uint16_t>(position.x - mPosition.x) < SIZE && static_cast<uint16_t>(position.y - mPosition.y) < SIZE;
+    }
+
+    // Draw the apple clipped to the viewport, or a marker on the viewport border showing where it is
+    template <class W>
+    void Draw(DisplayList &list, const vec2w &camera) const
+    {
+        const vec2w pos = W::ToScreen(mPosition, camera);
+        // Part of the apple inside the viewport (it can cross any side of it)
+        const int16_t left = max(pos.x, W::View::x);
+        const int16_t top = max(pos.y, W::View::y);
+        const int16_t right = min(pos.x + SIZE, W::View::right);
+        const int16_t bottom = min(pos.y + SIZE, W::View::bottom);
+        if (left < right && top < bottom)
+            list.Box(left, top, right - left, bottom - top);
+        else
+            list.Box(constrain(pos.x, W::View::x, W::View::right - 2), constrain(pos.y, W::View::y, W::View::bottom - 2), 2, 2);
+    }
 
 private:
-    Apple(const vec2i &position) : mPosition(position) {}
-    vec2i mPosition;
-    static const uint8_t SIZE = 5;
+    Apple(const vec2w &position) : mPosition(position) {}
+    vec2w mPosition;
 };
 
 class Snake
 {
 public:
-    Snake(const vec2i &startPosition, const vec2i &startDirection);
+    Snake(const vec2w &startPosition, const vec2i &startDirection, uint8_t rate);
     
-    inline vec2i GetHeadPosition() const { return mPositions.First(); }
+    inline vec2w GetHeadPosition() const { return mPositions.First(); }
 
-    // Returns the next head position of snake body for the next move
-    inline vec2i GetNextPosition(const Map &snakeMap) const
-    {
-        const vec2i &newPos = mPositions.First() + mDirection * mSpeed;
-        // Following two lines to enable if you want snake to go from left side to right side (modulo func.)
-        // newPos.x = posmod(newPos.x - snakeMap.pos.x, snakeMap.width) + snakeMap.pos.x;
-        // newPos.y = posmod(newPos.y - snakeMap.pos.y, snakeMap.height) + snakeMap.pos.y;
-        return newPos;
-    }
+    // Returns the next head position of snake body for the next move (always one cell away)
+    inline vec2w GetNextPosition() const { return mPositions.First() + mDirection; }
 
     inline uint8_t GetScore() const { return mScore; }
+    inline size_t GetLength() const { return mPositions.Count(); }
+
+    // Accumulate one frame of movement and return how many one-cell sub-steps have to be done
+    inline uint8_t Advance()
+    {
+        mProgress += mRate;
+        const uint8_t steps = mProgress >> 4;
+        mProgress &= 0x0F;
+        return steps;
+    }
 
-    MoveType GetNextMovementType(const Apple &apple, const Map &snakeMap);
+    // Apple and body check of the next move (map bounds are checked by the game)
+    MoveType GetNextMovementType(const Apple &apple);
+    // Queue a turn; the snake takes at most one turn per step (TakeTurn), so quick keys are not lost
     void ChangeDirection(const vec2i &newDirection);
-    void Move(const Map &snakeMap);
-    void Eat(const Apple &apple, const Map &snakeMap);
-    void Draw() const;
+    void TakeTurn();
+    void Move();
+    void Eat();
+    void Save(SnapshotWriter &writer) const;
+    void Load(SnapshotReader &reader);
+
+    // Draw only the body cells inside the viewport of world W (straight pieces become one line)
+    template <class W>
+    void Draw(DisplayList &list, const vec2w &camera) const
+    {
+        for (size_t i = 0; i < mPositions.Count(); ++i)
+        {
+            const vec2w &pos = mPositions[i];
+            if (!W::Visible(pos, camera))
+                continue;
+            const vec2w &screen = W::ToScreen(pos, camera);
+            list.Pixel(screen.x, screen.y);
+        }
+    }
 
 private:
-    List<vec2i> mPositions; // List of snake body cells positions
+    List<vec2w> mPositions; // List of snake body cells positions (world coordinates)
     vec2i mDirection;
-    uint8_t mSpeed;
+    uint8_t mTurns;     // Queued turns, 2-bit step codes, first one in the low bits
+    uint8_t mTurnCount;
+    uint8_t mRate;      // Cells per frame (4.4 fixed point)
+    uint8_t mProgress;  // Fractional cell travelled so far (low 4 bits)
     uint8_t mScore;
-    const uint8_t BODY_SIZE = 1;
 };
 
 
+// Snake game played in the world W (see World in Game.h) with the obstacles of a level, the camera follows the head
+template <class W>
 class SnakeGame : public Game
 {
 public:
-    SnakeGame(const Map &snakeMap);
-    void Update(int input) override;
+    SnakeGame(uint16_t seed);
+    void OnKey(Key key) override;
+    void Tick() override;
+    uint8_t WriteState(uint8_t *buffer) const override;
+    void Save(SnapshotWriter &writer) const override;
+    void Load(SnapshotReader &reader) override;
 
 private:
-    Map mSnakeMap;
+    // Declaration order matters: the snake starts as the level says, the apple is spawned away from the obstacles
+    Random mRandom;
+    uint8_t mLevel;
+    Obstacles<W> mObstacles;
     Snake mSnake;
     Apple mApple;
-    void Draw() const;
+    vec2w mCamera;
+    void Draw() const override;
+    void DrawField() const;
+    Apple SpawnApple();
 };
 
+// Instantiated in Snake.cpp
+extern template class SnakeGame<SnakeWorld>;
+
 #endif
@@ -0,0 +1,78 @@
+#include "Snapshot.h"
+#include "Game.h"
+
+#include <EEPROM.h>
+
+static inline uint8_t UpdateChecksum(uint8_t checksum, uint8_t value)
+{
+    return (checksum << 1 | checksum >> 7) ^ value;
+}
+
+SnapshotWriter::SnapshotWriter() : mLength(0), mChecksum(0)
+{
+    // The old header must not validate a half-new payload
+    ClearSnapshot();
+}
+
+void SnapshotWriter::Put(uint8_t value)
+{
+    if (mLength < SNAPSHOT_MAX_PAYLOAD)
+        // update() only writes bytes that changed (EEPROM cells wear out)
+        EEPROM.update(SNAPSHOT_ADDRESS + SNAPSHOT_HEADER + mLength, value);
+    mChecksum = UpdateChecksum(mChecksum, value);
+    mLength++;
+}
+
+void SnapshotWriter::Put16(uint16_t value)
+{
+    Put(value);
+    Put(value >> 8);
+}
+
+bool SnapshotWriter::Commit(GameId id)
+{
+    if (mLength > SNAPSHOT_MAX_PAYLOAD)
+    {
+        ClearSnapshot();
+        return false;
+    }
+    EEPROM.update(SNAPSHOT_ADDRESS + 1, SNAPSHOT_VERSION);
+    EEPROM.update(SNAPSHOT_ADDRESS + 2, static_cast<uint8_t>(id));
+    EEPROM.update(SNAPSHOT_ADDRESS + 3, mChecksum);
+    EEPROM.update(SNAPSHOT_ADDRESS + 4, mLength);
+    EEPROM.update(SNAPSHOT_ADDRESS + 5, mLength >> 8);
+    EEPROM.update(SNAPSHOT_ADDRESS, SNAPSHOT_MAGIC);
+    return true;
+}
+
+SnapshotReader::SnapshotReader() : mAddress(SNAPSHOT_ADDRESS + SNAPSHOT_HEADER), mValid(false)
+{
+    if (EEPROM.read(SNAPSHOT_ADDRESS) != SNAPSHOT_MAGIC || EEPROM.read(SNAPSHOT_ADDRESS + 1) != SNAPSHOT_VERSION)
+        return;
+
+    mGameId = static_cast<GameId>(EEPROM.read(SNAPSHOT_ADDRESS + 2));
+    const uint16_t length = EEPROM.read(SNAPSHOT_ADDRESS + 4) | EEPROM.read(SNAPSHOT_ADDRESS + 5) << 8;
+    if (length > SNAPSHOT_MAX_PAYLOAD)
+        return;
+
+    uint8_t checksum = 0;
+    for (uint16_t i = 0; i < length; ++i)
+        checksum = UpdateChecksum(checksum, EEPROM.read(mAddress + i));
+    mValid = checksum == EEPROM.read(SNAPSHOT_ADDRESS + 3);
+}
+
+uint8_t SnapshotReader::Get()
+{
+    return EEPROM.read(mAddress++);
+}
+
+uint16_t SnapshotReader::Get16()
+{
+    const uint8_t low = Get();
+    return low | Get() << 8;
+}
+
+void ClearSnapshot()
+{
+    EEPROM.update(SNAPSHOT_ADDRESS, 0);
+}
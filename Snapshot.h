@@ -0,0 +1,58 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+/*
+    Versioned binary snapshot of the running game, kept in EEPROM so that the game can be resumed
+    straight away after a power loss.
+        | magic | version | GameId | checksum | payload length (uint16) | payload |
+    The payload is written by Game::Save() and read back by Game::Load() in the same order.
+    Fields are little endian. Writing a snapshot first clears the magic, then writes the payload and
+    the header, magic last: a half-written snapshot (power loss while saving) is never valid.
+*/
+
+#include "Arduino.h"
+
+#define SNAPSHOT_MAGIC 0x47
+#define SNAPSHOT_VERSION 5
+#define SNAPSHOT_ADDRESS 0
+#define SNAPSHOT_HEADER 6
+// Payload must leave room for the header in the 1KB EEPROM of the ATmega328P
+#define SNAPSHOT_MAX_PAYLOAD (1024 - SNAPSHOT_ADDRESS - SNAPSHOT_HEADER)
+
+enum struct GameId : uint8_t;
+
+class SnapshotWriter
+{
+public:
+    // Invalidates the stored snapshot until Commit()
+    SnapshotWriter();
+    void Put(uint8_t value);
+    void Put16(uint16_t value);
+    // Write the header: the snapshot becomes valid. Returns false if the payload did not fit
+    bool Commit(GameId id);
+
+private:
+    uint16_t mLength;
+    uint8_t mChecksum;
+};
+
+class SnapshotReader
+{
+public:
+    // Checks header and checksum of the stored snapshot
+    SnapshotReader();
+    inline bool IsValid() const { return mValid; }
+    inline GameId GetGameId() const { return mGameId; }
+    uint8_t Get();
+    uint16_t Get16();
+
+private:
+    uint16_t mAddress;
+    GameId mGameId;
+    bool mValid;
+};
+
+// Invalidate the stored snapshot
+void ClearSnapshot();
+
+#endif
@@ -0,0 +1,40 @@
+#include "TileKeys.h"
+
+#ifdef __AVR__
+#include <util/crc16.h>
+#else
+// C version of the avr-libc function (see util/crc16.h)
+static inline uint16_t _crc_ccitt_update(uint16_t crc, uint8_t data)
+{
+    data ^= crc & 0xFF;
+    data ^= data << 4;
+    return (static_cast<uint16_t>(data) << 8 | crc >> 8) ^ static_cast<uint8_t>(data >> 4) ^ static_cast<uint16_t>(data) << 3;
+}
+#endif
+
+static uint16_t TileCrc(const uint8_t *tile)
+{
+    uint16_t crc = 0xFFFF;
+    for (uint8_t i = 0; i < 8; ++i)
+        crc = _crc_ccitt_update(crc, tile[i]);
+    return crc;
+}
+
+TileKeys::TileKeys() : mKeys(), mRefresh(0) {}
+
+bool TileKeys::Changed(uint8_t index, const uint8_t *tile)
+{
+    const uint16_t key = TileCrc(tile);
+    if (key == mKeys[index])
+        return false;
+    mKeys[index] = key;
+    return true;
+}
+
+void TileKeys::Sent(uint8_t index, const uint8_t *tile) { mKeys[index] = TileCrc(tile); }
+
+void TileKeys::Refresh()
+{
+    Forget(mRefresh);
+    mRefresh = (mRefresh + 1) % (TILES_X * TILES_Y);
+}
@@ -0,0 +1,35 @@
+#ifndef TILE_KEYS_H
+#define TILE_KEYS_H
+
+/*
+    What a receiver of the screen (the display, the Serial mirror) last got, tile by tile: the
+    screen is seen as 16x8 tiles of 8x8 pixels, and every tile is keyed by the CRC-16 (CCITT) of
+    its 8 bytes, so that only the tiles that changed since the last frame are sent.
+    A CRC-16 sees every change of up to 3 pixels in a tile, and misses any other change with a
+    chance of 1 in 65536; one tile per frame is still forgotten on purpose, so such a tile is
+    sent again within 128 frames.
+*/
+
+#include "Arduino.h"
+#include "Util.h"
+
+class TileKeys
+{
+public:
+    TileKeys();
+
+    // True if the tile differs from what was last sent at `index`; it's then remembered as sent
+    bool Changed(uint8_t index, const uint8_t *tile);
+    // The tile at `index` was sent (without asking if it changed)
+    void Sent(uint8_t index, const uint8_t *tile);
+    // The tile at `index` was not sent after all: it will differ next time
+    inline void Forget(uint8_t index) { mKeys[index] = ~mKeys[index]; }
+    // Call it once per frame: forget the next tile of the rolling refresh
+    void Refresh();
+
+private:
+    uint16_t mKeys[TILES_X * TILES_Y];
+    uint8_t mRefresh;
+};
+
+#endif
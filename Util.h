@@ -5,27 +5,18 @@
 // Done for memory efficiency
 using uint8_t = unsigned char;
 
-// -- IR KEYS --
-#define UP_KEY 0xFFFF906F
-#define DOWN_KEY 0xFFFFE01F
-#define POWER_KEY 0xFFFFA25D
-#define VOL_UP_KEY 0xFF629D
-#define VOL_DOWN_KEY 0xFFA857
-#define PLAY_PAUSE_KEY 0x2FD
-#define KEY_0 0x6897
-#define KEY_1 0x30CF
-#define KEY_2 0xFF18E7
-#define KEY_3 0x7A85
-#define KEY_4 0xFF10EF
-#define KEY_5 0x38C7
-#define KEY_6 0x5AA5
-#define KEY_7 0x42BD
-#define KEY_8 0xFF4AB5
-#define KEY_9 0x52AD
-
-#define HOLDING 0xFFFFFF
-
-// -- END IR KEYS --
+// IR remote layout: its codes are mapped to keys by the tables of KeyTables.h (see Keys.h)
+#define REMOTE_ELEGOO 0 // Elegoo 21-key remote
+#define REMOTE_KEYES 1  // Keyes 17-key remote
+#ifndef REMOTE_LAYOUT
+#define REMOTE_LAYOUT REMOTE_ELEGOO
+#endif
+
+// Display size, in pixels and in 8x8 tiles
+#define SCREEN_WIDTH 128
+#define SCREEN_HEIGHT 64
+#define TILES_X (SCREEN_WIDTH / 8)
+#define TILES_Y (SCREEN_HEIGHT / 8)
 
 // IR Receiver pin
 #define IR_PIN 7
@@ -33,4 +24,77 @@ using uint8_t = unsigned char;
 // BUZZER PIN
 #define BUZZER_PIN 3
 
+// Unconnected analog pin read at boot to seed the games
+#define NOISE_PIN A0
+
+// Serial link baud rate (binary protocol, see Protocol.h)
+#ifndef SERIAL_BAUD
+#define SERIAL_BAUD 115200
+#endif
+
+// Set to 1 to allow mirroring the screen to the host over the Serial link (see Mirror.h)
+#ifndef SCREEN_MIRROR
+#define SCREEN_MIRROR 0
+#endif
+
+// Game tick period (ms): games are updated at most this often (about the frame rate of a full
+// screen transfer, which the games were tuned for)
+#ifndef GAME_TICK_MS
+#define GAME_TICK_MS 33
+#endif
+
+// Most ticks run before drawing one frame when the loop is late (a slow frame, a burst of keys):
+// the game catches up without drawing the frames in between, older ticks are dropped
+#ifndef GAME_TICK_BATCH
+#define GAME_TICK_BATCH 4
+#endif
+
+// Set to 0 to spin instead of sleeping when there is nothing to do until the next tick (see Power.h)
+#ifndef IDLE_SLEEP
+#define IDLE_SLEEP 1
+#endif
+
+// Set to 1 to use the font subsets generated by tools/fontsubset.py (see Fonts.h)
+#ifndef FONT_SUBSET
+#define FONT_SUBSET 0
+#endif
+
+// Games and optional subsystems compiled in (set to 0 to leave them out of the firmware).
+// The menu lists the games that are compiled in (see Menu.cpp), tools/build_variants.sh
+// builds the usual combinations and reports their size
+#ifndef GAME_SNAKE
+#define GAME_SNAKE 1
+#endif
+#ifndef GAME_PONG
+#define GAME_PONG 1
+#endif
+// Buzzer beeps and the volume keys
+#ifndef FEATURE_SOUND
+#define FEATURE_SOUND 1
+#endif
+// Serial link (see Protocol.h): key injection, telemetry, counters and every report to the host
+#ifndef FEATURE_SERIAL
+#define FEATURE_SERIAL 1
+#endif
+
+// Set to 1 to count the CPU cycles of the instrumented functions (see Profile.h)
+#ifndef PROFILE
+#define PROFILE 0
+#endif
+
+// Set to 0 to send the whole screen to the display every frame instead of the changed tiles only
+#ifndef TILE_DIFF
+#define TILE_DIFF 1
+#endif
+
+// Set to 1 to send the display pages from the TWI interrupt instead of waiting for the bus in
+// nextPage() (see AsyncTwi.h, needs the compiler flag -DU8X8_NO_HW_I2C)
+#ifndef DISPLAY_ASYNC
+#define DISPLAY_ASYNC 0
+#endif
+
+#if SCREEN_MIRROR && !FEATURE_SERIAL
+#error "SCREEN_MIRROR needs the Serial link (FEATURE_SERIAL)"
+#endif
+
 #endif
@@ -0,0 +1,2 @@
+// AsyncTwiTest on the blocking transport (built with DISPLAY_ASYNC=0): nextPage() waits for the bus
+#include "AsyncTwiTest.cpp"
@@ -0,0 +1,107 @@
+/*
+    Asynchronous display transport (AsyncTwi.h) on the host stand-in of the TWI: how much of the
+    bus time of a frame overlaps the drawing of its pages. The CPU time is not simulated, so the
+    drawing of a page is given a time (DRAW_US) and every frame changes every tile.
+    Built twice: AsyncTwiTest with DISPLAY_ASYNC, AsyncTwiBlockingTest with the blocking HW_I2C
+    transport, where nextPage() waits for the bus and nothing overlaps.
+    The firmware then runs the menu on the transport: keys are traced until their frame is on
+    the display, and the queue empties between frames.
+*/
+
+#include "Host.h"
+#include "Game.h"
+#include "DisplayTransfer.h"
+#include "Latency.h"
+
+// Bus time of a byte and its ACK bit at TWI_CLOCK, in ns (22.5 us at 400kHz)
+#define BYTE_NS (9 * 1000000000ULL / TWI_CLOCK)
+
+// Drawing times of a page tried (us), a frame is 4 pages
+static const unsigned long DRAW_US[] = {0, 1000, 2000, 4000, 8000};
+
+struct FrameTime
+{
+    unsigned long drawUs;  // given to the drawing of the 4 pages
+    unsigned long busUs;   // bytes of the frame on the bus, an address byte per transaction
+    unsigned long cpuUs;   // until the last nextPage() returned
+    unsigned long shownUs; // until the last byte was on the bus
+    unsigned long waitUs;  // in the transport
+};
+
+// One frame, all white or all black so that every tile is sent
+static FrameTime Frame(unsigned long drawUs, bool white)
+{
+    const DisplayStats start = gDisplayStats;
+    const unsigned long now = micros();
+    FrameTime time = {};
+
+    u8g2.firstPage();
+    do
+    {
+        AdvanceMicros(drawUs);
+        time.drawUs += drawUs;
+        if (white)
+            u8g2.drawBox(0, 0, 128, 64);
+    } while (u8g2.nextPage());
+    time.cpuUs = micros() - now;
+#if DISPLAY_ASYNC
+    while (AsyncTwiBusy())
+        AdvanceMicros(1);
+#endif
+    time.shownUs = micros() - now;
+
+    const unsigned long bytes = gDisplayStats.bytes - start.bytes + gDisplayStats.transactions - start.transactions;
+    time.busUs = bytes * BYTE_NS / 1000;
+    time.waitUs = gDisplayStats.waitUs - start.waitUs;
+    return time;
+}
+
+int main()
+{
+    setup();
+    HostRun(2100);
+
+    printf("%s transport, frame of every tile:\n", DISPLAY_ASYNC ? "asynchronous" : "blocking");
+    for (uint8_t i = 0; i < sizeof(DRAW_US) / sizeof(DRAW_US[0]); ++i)
+    {
+        Frame(DRAW_US[i], false);
+        const FrameTime time = Frame(DRAW_US[i], true);
+        const long overlap = static_cast<long>(time.drawUs + time.busUs) - static_cast<long>(time.shownUs);
+        printf("  drawing %5lu us, bus %5lu us: CPU free after %5lu us, shown after %5lu us, %5lu us in the transport, "
+               "%5ld us overlapped\n",
+               time.drawUs, time.busUs, time.cpuUs, time.shownUs, time.waitUs, overlap);
+
+        // Both stand-ins take a byte time per data byte and per address byte: the frame is never
+        // shown before its bytes have been on the bus
+        CHECK(overlap >= 0);
+        if (DRAW_US[i] == 0)
+            CHECK(overlap <= 1);
+#if DISPLAY_ASYNC
+        // The next page is drawn while the queue is sent: the CPU is free before the frame is shown
+        else
+        {
+            CHECK(overlap > 0);
+            CHECK(time.cpuUs < time.shownUs);
+        }
+#else
+        else
+            CHECK(overlap <= 1);
+#endif
+    }
+
+    // The firmware on the transport: every menu key is traced once its frame is shown
+    gLatency.Reset();
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+        HostPressKey(i % 2 ? Key::UP : Key::DOWN);
+        HostRun(100);
+    }
+    const LatencyStats &stats = gLatency.stats;
+    printf("menu: %u keys, average %.1f ms, worst %u ms\n", stats.keys, static_cast<double>(stats.totalMs) / max(stats.keys, 1), stats.worstMs);
+    CHECK(stats.keys == 8);
+    CHECK(gDisplayStats.busErrors == 0);
+#if DISPLAY_ASYNC
+    CHECK(!AsyncTwiBusy());
+#endif
+    return HostResult(DISPLAY_ASYNC ? "AsyncTwiTest" : "AsyncTwiBlockingTest");
+}
@@ -0,0 +1,165 @@
+/*
+    Golden frames and frame budgets: a scripted session through the welcome screen, the menu,
+    Snake and Pong with a fixed seed. Every screen is compared with its golden PBM, and the frames
+    drawn through the display list are checked against a budget of draw calls, pixels and
+    allocations (List growth in Snake, nothing else allocates after setup).
+    Then an apple is drawn across every side of the Snake viewport: only its visible part is drawn.
+    The display list is sized from the worst frame of the levels without the snake, for every
+    camera position; a frame that does not fit the list must be drawn the same and every
+    command only on the pages it covers.
+*/
+
+#include "Host.h"
+#include "DisplayList.h"
+#include "Random.h"
+#include "Snake.h"
+#include "Level.h"
+
+#include <U8g2lib.h>
+
+// Commands in the list left for the snake in the worst frame of the levels
+#define MIN_SNAKE_COMMANDS 20
+
+// Budgets of every frame of the session
+#define MAX_DRAW_CALLS 24
+#define MAX_PIXELS 800
+#define MAX_ALLOCATIONS_PER_SECOND 2
+
+// Play `ms` of a game, and check the frames drawn and the allocations made meanwhile
+static void Play(const char *game, unsigned long ms)
+{
+    gDisplayList.ResetWorst();
+    gU8g2Pixels.worst = 0;
+    const uint16_t frames = gDisplayList.stats.frames;
+    const unsigned long allocations = gHostAllocations;
+    HostRun(ms);
+
+    const FrameCost &worst = gDisplayList.stats.worst;
+    printf("%s: %u frames, worst %u commands, %u draw calls, %u pixels, %lu allocations\n", game,
+           gDisplayList.stats.frames - frames, worst.commands, worst.drawCalls, gU8g2Pixels.worst, gHostAllocations - allocations);
+    CHECK(gDisplayList.stats.frames > frames);
+    CHECK(worst.drawCalls <= MAX_DRAW_CALLS);
+    CHECK(gU8g2Pixels.worst <= MAX_PIXELS);
+    CHECK(gHostAllocations - allocations <= MAX_ALLOCATIONS_PER_SECOND * (ms / 1000 + 1));
+}
+
+// Draw an apple of the Snake world seen from `camera` alone, and count its pixels
+static uint16_t ApplePixels(const vec2w &position, const vec2w &camera)
+{
+    const Apple apple = Apple::Spawn(position);
+    gDisplayList.Render([&](DisplayList &list) { apple.Draw<SnakeWorld>(list, camera); });
+    return HostCountPixels(gU8g2Frame);
+}
+
+static void CheckAppleClipping()
+{
+    const uint8_t size = Apple::SIZE;
+    // Whole, then 2 columns or rows out of the viewport on every side (visible part: 3 of 5)
+    CHECK(ApplePixels({20, 20}, {0, 0}) == size * size);
+    CHECK(ApplePixels({20, 20}, {22, 0}) == 3 * size);
+    CHECK(ApplePixels({20, 20}, {0, 22}) == 3 * size);
+    CHECK(ApplePixels({20 + SnakeMap::width - 3, 20}, {20, 0}) == 3 * size);
+    CHECK(ApplePixels({20, 20 + SnakeMap::height - 3}, {0, 20}) == 3 * size);
+    CHECK(ApplePixels({20, 20}, {22, 22}) == 3 * 3);
+    // Out of the viewport: the 2x2 marker on its border
+    CHECK(ApplePixels({20, 20}, {25, 0}) == 2 * 2);
+}
+
+// Most commands of a Snake frame without the snake, over every level and camera position
+static void CheckLevelCommands()
+{
+    uint8_t worst = 0;
+    for (uint8_t i = 0; i < GetLevelCount(); ++i)
+    {
+        const Obstacles<SnakeWorld> obstacles(GetLevel(i).runs);
+        for (int16_t y = 0; y <= SnakeWorld::height - SnakeMap::height; ++y)
+        {
+            for (int16_t x = 0; x <= SnakeWorld::width - SnakeMap::width; ++x)
+            {
+                const vec2w camera = {x, y};
+                gDisplayList.Render([&](DisplayList &list)
+                {
+                    SnakeWorld::DrawWalls(list, camera);
+                    obstacles.Draw(list, camera);
+                    list.Number(110, 13, 0);
+                    list.Box(60, 30, Apple::SIZE, Apple::SIZE);
+                });
+                worst = max(worst, gDisplayList.stats.last.commands);
+            }
+        }
+    }
+    printf("levels: worst %u commands without the snake, %u left for it\n", worst, DISPLAY_LIST_SIZE - worst);
+    CHECK(worst + MIN_SNAKE_COMMANDS <= DISPLAY_LIST_SIZE);
+}
+
+// A frame of 3 list sizes of lines, each made of pixels: it must look the same as drawn directly
+static void CheckOverflow()
+{
+    const uint8_t lines = 3 * DISPLAY_LIST_SIZE;
+    u8g2.firstPage();
+    do
+    {
+        for (uint8_t i = 0; i < lines; ++i)
+            u8g2.drawHLine(i, i % 64, 10);
+    } while (u8g2.nextPage());
+    uint8_t expected[HOST_SCREEN_SIZE];
+    memcpy(expected, gU8g2Frame, sizeof(expected));
+
+    const uint16_t immediateFrames = gDisplayList.stats.immediateFrames;
+    gDisplayList.Render([&](DisplayList &list)
+    {
+        for (uint8_t i = 0; i < lines; ++i)
+        {
+            for (uint8_t x = i; x < i + 10; ++x)
+                list.Pixel(x, i % 64);
+        }
+    });
+    const FrameCost &cost = gDisplayList.stats.last;
+    printf("overflow: %u commands, %u draw calls\n", cost.commands, cost.drawCalls);
+    CHECK(gDisplayList.stats.immediateFrames == immediateFrames + 1);
+    CHECK(cost.commands == lines);
+    // One row each: every line is on one page, drawn once
+    CHECK(cost.drawCalls == lines);
+    CHECK(memcmp(gU8g2Frame, expected, sizeof(expected)) == 0);
+}
+
+int main()
+{
+    setup();
+    gRandomSeed = 1234;
+    HostCheckGolden("welcome", gU8g2Frame);
+
+    // The welcome screen times out into the menu
+    HostRun(2100);
+    HostCheckGolden("menu", gU8g2Frame);
+
+    HostPressKey(Key::PLAY_PAUSE);
+    HostRun(10);
+    HostCheckGolden("snake-start", gU8g2Frame);
+    Play("snake", 3000);
+    HostCheckGolden("snake", gU8g2Frame);
+
+    HostPressKey(Key::PLAY_PAUSE);
+    HostRun(10);
+    HostCheckGolden("pause", gU8g2Frame);
+
+    // Back to the menu, then Pong
+    HostPressKey(Key::PLAY_PAUSE);
+    HostRun(10);
+    HostPressKey(Key::POWER);
+    HostRun(10);
+    HostPressKey(Key::DOWN);
+    HostRun(10);
+    HostCheckGolden("menu-pong", gU8g2Frame);
+
+    HostPressKey(Key::PLAY_PAUSE);
+    HostRun(10);
+    HostCheckGolden("pong-start", gU8g2Frame);
+    Play("pong", 3000);
+    HostCheckGolden("pong", gU8g2Frame);
+
+    CheckAppleClipping();
+    CheckLevelCommands();
+    CheckOverflow();
+    return HostResult("FrameTest");
+}
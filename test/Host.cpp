@@ -0,0 +1,138 @@
+#include "Host.h"
+#include "KeyTables.h"
+
+#include <IRremote.h>
+#include <new>
+
+unsigned gHostFailures;
+unsigned long gHostAllocations;
+
+void *operator new(size_t size)
+{
+    gHostAllocations++;
+    if (void *p = malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+void HostRun(unsigned long ms)
+{
+    const unsigned long end = micros() + ms * 1000;
+    while (static_cast<long>(end - micros()) > 0)
+    {
+        const unsigned long start = millis();
+        loop();
+        if (millis() == start)
+            AdvanceMicros(1000 - micros() % 1000);
+    }
+}
+
+void HostPressKey(Key key)
+{
+    for (uint8_t i = 0; i < sizeof(KEY_TABLE) / sizeof(KEY_TABLE[0]); ++i)
+    {
+        if (KEY_TABLE[i].key == key)
+        {
+            IRrecv::Receive(KEY_TABLE[i].code);
+            return;
+        }
+    }
+    printf("key %d is not on the remote layout\n", static_cast<int>(key));
+    gHostFailures++;
+}
+
+uint16_t HostCountPixels(const uint8_t *screen)
+{
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < HOST_SCREEN_SIZE; ++i)
+        count += __builtin_popcount(screen[i]);
+    return count;
+}
+
+// PBM (P4): rows of 16 bytes, leftmost pixel in the top bit, set pixels are 1
+static void ToPbm(const uint8_t *screen, uint8_t *rows)
+{
+    memset(rows, 0, HOST_SCREEN_SIZE);
+    for (uint8_t y = 0; y < 64; ++y)
+    {
+        for (uint8_t x = 0; x < 128; ++x)
+        {
+            if (screen[y / 8 * 128 + x] >> (y % 8) & 1)
+                rows[y * 16 + x / 8] |= 0x80 >> (x % 8);
+        }
+    }
+}
+
+static bool WritePbm(const char *path, const uint8_t *rows)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+        return false;
+    fprintf(file, "P4\n128 64\n");
+    const bool written = fwrite(rows, 1, HOST_SCREEN_SIZE, file) == HOST_SCREEN_SIZE;
+    return fclose(file) == 0 && written;
+}
+
+static bool ReadPbm(const char *path, uint8_t *rows)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+        return false;
+    char header[16];
+    const bool read = fgets(header, sizeof(header), file) && strcmp(header, "P4\n") == 0 &&
+                      fgets(header, sizeof(header), file) && strcmp(header, "128 64\n") == 0 &&
+                      fread(rows, 1, HOST_SCREEN_SIZE, file) == HOST_SCREEN_SIZE;
+    fclose(file);
+    return read;
+}
+
+bool HostCheckGolden(const char *name, const uint8_t *screen)
+{
+    uint8_t rows[HOST_SCREEN_SIZE];
+    uint8_t golden[HOST_SCREEN_SIZE];
+    char path[128];
+    ToPbm(screen, rows);
+
+    snprintf(path, sizeof(path), "golden/%s.pbm", name);
+    if (getenv("UPDATE_GOLDEN") != NULL)
+    {
+        if (WritePbm(path, rows))
+            return true;
+        printf("cannot write %s\n", path);
+        gHostFailures++;
+        return false;
+    }
+    if (!ReadPbm(path, golden))
+    {
+        printf("cannot read %s (run with UPDATE_GOLDEN=1 to create it)\n", path);
+        gHostFailures++;
+        return false;
+    }
+
+    uint16_t differences = 0;
+    for (uint16_t i = 0; i < HOST_SCREEN_SIZE; ++i)
+        differences += __builtin_popcount(rows[i] ^ golden[i]);
+    if (differences == 0)
+        return true;
+
+    snprintf(path, sizeof(path), "build/%s.pbm", name);
+    WritePbm(path, rows);
+    printf("frame %s: %u pixels differ from golden/%s.pbm, see %s\n", name, differences, name, path);
+    gHostFailures++;
+    return false;
+}
+
+int HostResult(const char *test)
+{
+    if (gHostFailures == 0)
+        printf("%s: ok\n", test);
+    else
+        printf("%s: %u checks failed\n", test, gHostFailures);
+    return gHostFailures == 0 ? 0 : 1;
+}
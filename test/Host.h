@@ -0,0 +1,57 @@
+#ifndef HOST_H
+#define HOST_H
+
+/*
+    Host test harness: the whole firmware (GamePad.ino included) is built with g++ against the
+    stand-ins of test/stub, and driven by the tests through setup()/loop() on a simulated clock.
+    Keys go through the IR receiver stand-in, frames are read back from the SSD1306 stand-in.
+    Every test is its own program (see Makefile); it returns the number of failed checks.
+*/
+
+#include "Arduino.h"
+#include "Keys.h"
+
+#include <stdio.h>
+
+// Screen size in bytes (SSD1306 layout, see U8g2lib.h)
+#define HOST_SCREEN_SIZE (128 * 64 / 8)
+
+extern unsigned gHostFailures;
+
+#define CHECK(condition)                                                        \
+    do                                                                          \
+    {                                                                           \
+        if (!(condition))                                                       \
+        {                                                                       \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            gHostFailures++;                                                    \
+        }                                                                       \
+    } while (0)
+
+// Firmware entry points (GamePad.ino)
+void setup();
+void loop();
+
+// Run loop() for `ms` of simulated time; the MCU sleeps until the next millis tick when loop()
+// did not take a whole millisecond (the time of the display transfers is simulated)
+void HostRun(unsigned long ms);
+
+// Press a key of the remote layout (received by the next loop())
+void HostPressKey(Key key);
+
+// Number of pixels set in a screen
+uint16_t HostCountPixels(const uint8_t *screen);
+
+/*
+    Compare a screen with golden/<name>.pbm. A screen that differs is written in build/<name>.pbm
+    to look at it; with the environment variable UPDATE_GOLDEN set, the golden file is written instead.
+*/
+bool HostCheckGolden(const char *name, const uint8_t *screen);
+
+// operator new calls since start (List allocations among them)
+extern unsigned long gHostAllocations;
+
+// Print the result of a test program and return its exit code
+int HostResult(const char *test);
+
+#endif
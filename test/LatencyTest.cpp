@@ -0,0 +1,69 @@
+/*
+    Input-to-photon latency of the firmware on the host: keys are pressed at every phase of the
+    game tick, on the menu and in Snake, and the histogram of LatencyTrace (the one GET_LATENCY
+    reads on the device) is reported in simulated milliseconds and in frames of GAME_TICK_MS.
+    The simulated time is the tick wait and the display bus time (the CPU time is not simulated).
+*/
+
+#include "Host.h"
+#include "Latency.h"
+
+// Full screen on the bus (1104 bytes at 400kHz, see test/stub/U8g2lib.cpp), rounded up
+#define FULL_FRAME_MS 25
+
+static void Report(const char *session)
+{
+    const LatencyStats &stats = gLatency.stats;
+    if (stats.keys == 0)
+    {
+        printf("%s: no key traced\n", session);
+        gHostFailures++;
+        return;
+    }
+    const double average = static_cast<double>(stats.totalMs) / stats.keys;
+    printf("%s: %u keys, average %.1f ms (%.2f frames), worst %u ms (%.2f frames)\n", session, stats.keys, average,
+           average / GAME_TICK_MS, stats.worstMs, static_cast<double>(stats.worstMs) / GAME_TICK_MS);
+    for (uint8_t i = 0; i < LATENCY_BUCKETS; ++i)
+    {
+        if (i < LATENCY_BUCKETS - 1)
+            printf("  < %3u ms %4u\n", 8 << i, stats.buckets[i]);
+        else
+            printf("  >= %2u ms %4u\n", 4 << i, stats.buckets[i]);
+    }
+}
+
+int main()
+{
+    setup();
+    HostRun(2100);
+
+    // Menu: a key redraws the static screen right away, the latency is the frame transfer
+    gLatency.Reset();
+    for (uint8_t i = 0; i < GAME_TICK_MS; ++i)
+    {
+        HostPressKey(i % 2 ? Key::UP : Key::DOWN);
+        HostRun(100 + i);
+    }
+    Report("menu");
+    CHECK(gLatency.stats.keys == GAME_TICK_MS);
+    CHECK(gLatency.stats.worstMs <= FULL_FRAME_MS);
+
+    // Snake: a turn shows when the snake next moves, at most a tick later at the fastest level
+    // speed (slower levels move every few ticks), then the frame is sent
+    HostPressKey(Key::DOWN);
+    HostRun(10);
+    HostPressKey(Key::PLAY_PAUSE);
+    HostRun(100);
+    gLatency.Reset();
+    const Key turns[] = {Key::DIGIT_8, Key::DIGIT_6, Key::DIGIT_2, Key::DIGIT_4};
+    for (uint8_t i = 0; i < GAME_TICK_MS; ++i)
+    {
+        HostPressKey(turns[i % 4]);
+        HostRun(50 + i);
+    }
+    Report("snake");
+    CHECK(gLatency.stats.keys > 0);
+    CHECK(gLatency.stats.worstMs <= 4 * GAME_TICK_MS + FULL_FRAME_MS);
+
+    return HostResult("LatencyTest");
+}
@@ -0,0 +1,71 @@
+/*
+    vec2i properties against a scalar reference (each component on its own, in int):
+    wrapping add/sub, saturating add, negation, multiplication and equality.
+    Every pair of x values is tried with random y values and the other way round, so every carry
+    and borrow out of a lane is covered, plus random pairs of whole words.
+*/
+
+#include "Host.h"
+#include "Math.h"
+#include "Random.h"
+
+static int8_t Wrap(int value) { return static_cast<int8_t>(static_cast<uint8_t>(value)); }
+static int8_t Clamp(int value) { return value < -128 ? -128 : value > 127 ? 127 : value; }
+
+static bool Equals(const vec2i &v, int x, int y) { return v.x == x && v.y == y; }
+
+static void CheckPair(int8_t ax, int8_t ay, int8_t bx, int8_t by)
+{
+    const vec2i a(ax, ay);
+    const vec2i b(bx, by);
+
+    CHECK(Equals(a + b, Wrap(ax + bx), Wrap(ay + by)));
+    CHECK(Equals(a - b, Wrap(ax - bx), Wrap(ay - by)));
+    CHECK(Equals(a.AddSat(b), Clamp(ax + bx), Clamp(ay + by)));
+    CHECK((a == b) == (ax == bx && ay == by));
+    CHECK((a != b) == !(ax == bx && ay == by));
+
+    vec2i sum = a;
+    sum += b;
+    CHECK(sum == a + b);
+}
+
+static void CheckOne(int8_t x, int8_t y)
+{
+    const vec2i v(x, y);
+    CHECK(Equals(v, x, y));
+    CHECK(Equals(-v, Wrap(-x), Wrap(-y)));
+    CHECK(vec2i::FromWord(v.word) == v);
+    for (int factor = -128; factor <= 127; factor += 5)
+        CHECK(Equals(v * factor, Wrap(x * factor), Wrap(y * factor)));
+}
+
+int main()
+{
+    Random random(1, RandomStream::SNAKE_APPLE);
+
+    for (int a = -128; a <= 127; ++a)
+    {
+        for (int b = -128; b <= 127; ++b)
+        {
+            CheckPair(a, random.Next(), b, random.Next());
+            CheckPair(random.Next(), a, random.Next(), b);
+        }
+        for (int b = -128; b <= 127; ++b)
+            CheckOne(a, b);
+    }
+    for (uint32_t i = 0; i < 1000000; ++i)
+    {
+        const vec2i a = vec2i::FromWord(random.Next());
+        const vec2i b = vec2i::FromWord(random.Next());
+        CheckPair(a.x, a.y, b.x, b.y);
+    }
+
+    // Directions are signed and keep their sign when added to a position
+    CHECK(Equals(vec2i(10, 20) + vec2i(-1, 0), 9, 20));
+    CHECK(Equals(vec2i(10, 20) + vec2i(0, -1), 10, 19));
+    CHECK(Equals(vec2i(0, 0) - vec2i(1, 1), -1, -1));
+    CHECK(Equals(vec2i(127, -128) + vec2i(1, -1), -128, 127));
+
+    return HostResult("MathTest");
+}
@@ -0,0 +1,61 @@
+/*
+    Multi-ball Pong: cost of moving 1 to 32 balls (built with PONG_BALLS=32, the capacity; the
+    balls in play are what the loop walks). Every round serves the balls again and moves them
+    for ROUND_STEPS steps; balls leaving the map are counted, none is lost or duplicated.
+    Times are host times: they show how the cost grows with the balls, not AVR cycles.
+*/
+
+#include "Host.h"
+#include "Pong.h"
+
+#include <time.h>
+
+#define ROUND_STEPS 32
+#define ROUNDS 20000
+
+static double Seconds()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+int main()
+{
+    Random random(1234, RandomStream::PONG_BALL);
+    const Paddle left(vec2i(PongMap::x + PADDLE_OFFSET, PongMap::centerY), false);
+    const Paddle right(vec2i(PongMap::right - PADDLE_OFFSET, PongMap::centerY), true);
+    Balls<PONG_BALLS> balls;
+    double single = 0;
+
+    for (uint8_t count = 1; count <= PONG_BALLS; count *= 2)
+    {
+        unsigned long moved = 0;
+        double elapsed = 0;
+        for (uint16_t round = 0; round < ROUNDS; ++round)
+        {
+            balls.Clear();
+            for (uint8_t i = 0; i < count; ++i)
+                balls.Add(vec2i(PongMap::centerX + random.Below(16) - 8, PongMap::y + 1 + random.Below(PongMap::height - 2)),
+                          vec2i(random.Sign(), random.Sign()));
+
+            uint8_t leftOut = 0, rightOut = 0;
+            const double start = Seconds();
+            for (uint8_t step = 0; step < ROUND_STEPS; ++step)
+            {
+                moved += balls.GetCount();
+                balls.Move<PongMap>(left, right, leftOut, rightOut);
+            }
+            elapsed += Seconds() - start;
+            CHECK(balls.GetCount() + leftOut + rightOut == count);
+        }
+
+        const double perBall = elapsed * 1e9 / moved;
+        if (count == 1)
+            single = perBall;
+        printf("%2u balls: %6.2f ns per step, %5.2f ns per ball\n", count, elapsed * 1e9 / (ROUNDS * ROUND_STEPS), perBall);
+        // Linear in the balls: a ball does not cost more when there are more of them
+        CHECK(perBall < 2 * single);
+    }
+    return HostResult("PongBench");
+}
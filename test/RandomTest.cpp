@@ -0,0 +1,151 @@
+/*
+    Random streams: properties of the generator and of the game seeds, and a benchmark of the
+    bounded draws against Arduino random(min, max) (avr-libc random(): Park-Miller with 32-bit
+    divisions). The benchmark runs on the host: it compares the two algorithms, not AVR cycles.
+*/
+
+#include "Host.h"
+#include "Random.h"
+#include "Level.h"
+
+#include <time.h>
+
+// avr-libc random(), and the Arduino core bounded draw on top of it
+static unsigned long sArduinoState = 1;
+
+static long AvrLibcRandom()
+{
+    long x = sArduinoState;
+    if (x == 0)
+        x = 123459876L;
+    const long hi = x / 127773L;
+    const long lo = x % 127773L;
+    x = 16807L * lo - 2836L * hi;
+    if (x < 0)
+        x += 0x7FFFFFFFL;
+    sArduinoState = x;
+    return x % 0x80000000UL;
+}
+
+static long ArduinoRandom(long low, long high) { return AvrLibcRandom() % (high - low) + low; }
+
+static double Seconds()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+#define DRAWS 10000000UL
+
+static void Benchmark()
+{
+    volatile uint16_t sink = 0;
+    Random random(1234, RandomStream::PONG_BALL);
+
+    double start = Seconds();
+    for (unsigned long i = 0; i < DRAWS; ++i)
+        sink = random.Below(MAP_WIDTH);
+    const double below = Seconds() - start;
+
+    start = Seconds();
+    for (unsigned long i = 0; i < DRAWS; ++i)
+        sink = ArduinoRandom(0, MAP_WIDTH);
+    const double arduino = Seconds() - start;
+
+    start = Seconds();
+    for (unsigned long i = 0; i < DRAWS; ++i)
+        sink = random.Sign();
+    const double sign = Seconds() - start;
+
+    // The old direction picker: random(-1, 2) until it's not 0
+    start = Seconds();
+    for (unsigned long i = 0; i < DRAWS; ++i)
+    {
+        long value;
+        do
+            value = ArduinoRandom(-1, 2);
+        while (value == 0);
+        sink = value;
+    }
+    const double rejection = Seconds() - start;
+    (void)sink;
+
+    printf("Below(%u): %.2f ns/draw, Arduino random(0, %u): %.2f ns/draw\n", MAP_WIDTH, below * 1e9 / DRAWS, MAP_WIDTH, arduino * 1e9 / DRAWS);
+    printf("Sign(): %.2f ns/draw, Arduino random(-1, 2) until not 0: %.2f ns/draw\n", sign * 1e9 / DRAWS, rejection * 1e9 / DRAWS);
+}
+
+int main()
+{
+    // Full period: every non-zero state comes back after 65535 draws, zero is never reached
+    Random random(1, RandomStream::SNAKE_APPLE);
+    const uint16_t first = random.GetState();
+    uint16_t period = 0;
+    do
+    {
+        CHECK(random.Next() != 0);
+        period++;
+    } while (random.GetState() != first && period != 0);
+    CHECK(period == 0xFFFF);
+
+    // A saved state is restored as it is, only zero is replaced
+    for (uint32_t state = 1; state <= 0xFFFF; ++state)
+    {
+        random.SetState(state);
+        CHECK(random.GetState() == state);
+    }
+    random.SetState(0);
+    CHECK(random.GetState() != 0);
+
+    // Every seed of a stream starts its own sequence, but the one that would be the zero state
+    uint32_t shared = 0;
+    for (uint32_t seed = 0; seed <= 0xFFFF; ++seed)
+        shared += Random(seed, RandomStream::SNAKE_APPLE).GetState() != (seed ^ Random(0, RandomStream::SNAKE_APPLE).GetState());
+    CHECK(shared == 1);
+    CHECK(Random(1234, RandomStream::PONG_BALL).Next() != Random(1234 ^ 1, RandomStream::PONG_BALL).Next());
+
+    // Bounded draws are in range and uniform within 2%, signs are balanced
+    uint32_t counts[10] = {};
+    for (uint32_t i = 0; i < 655350; ++i)
+    {
+        const uint16_t value = random.Below(10);
+        CHECK(value < 10);
+        counts[value < 10 ? value : 0]++;
+    }
+    for (uint8_t i = 0; i < 10; ++i)
+        CHECK(counts[i] > 65535 * 98 / 100 && counts[i] < 65535 * 102 / 100);
+    int32_t signs = 0;
+    for (uint32_t i = 0; i < 65535; ++i)
+    {
+        const int8_t sign = random.Sign();
+        CHECK(sign == -1 || sign == 1);
+        signs += sign;
+    }
+    CHECK(signs > -655 && signs < 655);
+
+    // Every game of a power cycle gets its own seed, and so Snake its own level; the seed
+    // reported for a game replays it
+    gRandomSeed = 1234;
+    uint16_t seeds[16];
+    bool levels[16] = {};
+    for (uint8_t game = 0; game < 16; ++game)
+    {
+        seeds[game] = NextGameSeed();
+        CHECK(seeds[game] == gGameSeed);
+        for (uint8_t other = 0; other < game; ++other)
+            CHECK(seeds[other] != seeds[game]);
+        levels[Random(seeds[game], RandomStream::SNAKE_LEVEL).Below(GetLevelCount())] = true;
+    }
+    uint8_t levelCount = 0;
+    for (uint8_t level = 0; level < GetLevelCount(); ++level)
+        levelCount += levels[level];
+    printf("%u of %u Snake levels drawn in 16 games\n", levelCount, GetLevelCount());
+    CHECK(levelCount > 1);
+
+    gRandomSeed = seeds[5];
+    CHECK(NextGameSeed() == seeds[5]);
+    CHECK(NextGameSeed() == seeds[6]);
+
+    Benchmark();
+    return HostResult("RandomTest");
+}
@@ -0,0 +1,2 @@
+// TransferTest without the tile diff (built with TILE_DIFF=0): every tile of every frame is sent
+#include "TransferTest.cpp"
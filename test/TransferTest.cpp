@@ -0,0 +1,101 @@
+/*
+    Display transfer: bytes and I2C transactions per frame counted by the transfer layer on the
+    stand-in transport, over a session of Snake and Pong, and what reaches the display.
+    Built twice: TransferTest with the tile diff, TransferFullTest without it (TILE_DIFF=0), the
+    cost of sending the whole screen every frame. Either way, the display must show every frame
+    exactly as drawn: not a single tile may be left stale. The tile keys must see every change of
+    up to 3 pixels in a tile.
+*/
+
+#include "Host.h"
+#include "DisplayTransfer.h"
+#include "TileKeys.h"
+
+#include <U8g2lib.h>
+
+// Most bytes per frame with the tile diff, in a session where only the game objects move
+#define MAX_TILE_DIFF_BYTES 300
+
+// Tiles that differed from the frame drawn, over every check
+static unsigned long sStaleTiles;
+
+static void CheckDisplay()
+{
+    for (uint8_t tile = 0; tile < TILES_X * TILES_Y; ++tile)
+    {
+        if (memcmp(gSsd1306Ram + tile * 8, gU8g2Frame + tile * 8, 8) != 0)
+            sStaleTiles++;
+    }
+}
+
+// Play `ms` of a game and report what was sent per frame
+static void Play(const char *game, unsigned long ms)
+{
+    const DisplayStats start = gDisplayStats;
+    const unsigned long frames = gU8g2Frames;
+    for (const unsigned long end = millis() + ms; millis() < end;)
+    {
+        HostRun(1);
+        CheckDisplay();
+    }
+
+    const unsigned long played = gU8g2Frames - frames;
+    const unsigned long bytes = (gDisplayStats.bytes - start.bytes) / played;
+    printf("%s: %lu frames, %lu bytes and %lu transactions per frame, %u tiles sent, %u skipped\n", game, played, bytes,
+           (gDisplayStats.transactions - start.transactions) / played, gDisplayStats.tilesSent - start.tilesSent,
+           gDisplayStats.tilesSkipped - start.tilesSkipped);
+    CHECK(played > 0);
+#if TILE_DIFF
+    CHECK(bytes <= MAX_TILE_DIFF_BYTES);
+#endif
+}
+
+// Every tile with 1 to 3 pixels flipped from a tile that was sent is seen as changed
+static void CheckTileKeys()
+{
+    TileKeys keys;
+    const uint8_t sent[8] = {0x3C, 0x42, 0x81, 0xA5, 0x81, 0x99, 0x42, 0x3C};
+    unsigned long missed = 0;
+    for (uint8_t a = 0; a < 64; ++a)
+    {
+        for (uint8_t b = a; b < 64; ++b)
+        {
+            for (uint8_t c = b; c < 64; ++c)
+            {
+                uint8_t tile[8];
+                memcpy(tile, sent, sizeof(tile));
+                tile[a / 8] ^= 1 << a % 8;
+                if (b != a)
+                    tile[b / 8] ^= 1 << b % 8;
+                if (c != b)
+                    tile[c / 8] ^= 1 << c % 8;
+                keys.Sent(0, sent);
+                missed += !keys.Changed(0, tile);
+            }
+        }
+    }
+    CHECK(missed == 0);
+}
+
+int main()
+{
+    CheckTileKeys();
+
+    setup();
+    HostRun(2100);
+
+    HostPressKey(Key::PLAY_PAUSE);
+    Play("snake", 5000);
+    HostPressKey(Key::PLAY_PAUSE);
+    HostRun(10);
+    HostPressKey(Key::POWER);
+    HostRun(10);
+    HostPressKey(Key::DOWN);
+    HostRun(10);
+    HostPressKey(Key::PLAY_PAUSE);
+    Play("pong", 5000);
+
+    printf("%lu tiles left stale on the display\n", sStaleTiles);
+    CHECK(sStaleTiles == 0);
+    return HostResult(TILE_DIFF ? "TransferTest" : "TransferFullTest");
+}
@@ -0,0 +1,85 @@
+#include "Arduino.h"
+#include "EEPROM.h"
+
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+
+// Simulated time, in microseconds since reset
+static unsigned long sMicros;
+
+unsigned long micros() { return sMicros; }
+unsigned long millis() { return sMicros / 1000; }
+void delay(unsigned long ms) { sMicros += ms * 1000; }
+void delayMicroseconds(unsigned int us) { sMicros += us; }
+void AdvanceMicros(unsigned long us) { sMicros += us; }
+
+// A floating pin: the same noise on every run
+int analogRead(uint8_t pin)
+{
+    static uint16_t noise = 0xACE1;
+    noise = noise >> 1 ^ (-(noise & 1) & 0xB400);
+    return noise & 0x3FF;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {}
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void randomSeed(unsigned long seed) { srand(seed); }
+long random(long max) { return max > 0 ? rand() % max : 0; }
+long random(long min, long max) { return min < max ? min + random(max - min) : min; }
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+        write(buffer[i]);
+    return size;
+}
+
+size_t Print::print(const __FlashStringHelper *text) { return print(reinterpret_cast<const char *>(text)); }
+
+size_t Print::print(const char *text) { return write(reinterpret_cast<const uint8_t *>(text), strlen(text)); }
+
+size_t Print::print(char value) { return write(static_cast<uint8_t>(value)); }
+
+size_t Print::print(long value, int base)
+{
+    if (value >= 0)
+        return print(static_cast<unsigned long>(value), base);
+    return print('-') + print(static_cast<unsigned long>(-value), base);
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+    char digits[33];
+    char *p = digits + sizeof(digits) - 1;
+    *p = '\0';
+    do
+    {
+        const uint8_t digit = value % base;
+        *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+        value /= base;
+    } while (value > 0);
+    return print(p);
+}
+
+int HardwareSerial::read()
+{
+    if (mCount == 0)
+        return -1;
+    const uint8_t value = mRx[mHead];
+    mHead = (mHead + 1) % SERIAL_RX_SIZE;
+    mCount--;
+    return value;
+}
+
+size_t HardwareSerial::write(uint8_t value)
+{
+    txBytes++;
+    return 1;
+}
+
+void HardwareSerial::Receive(const uint8_t *bytes, uint8_t length)
+{
+    for (uint8_t i = 0; i < length && mCount < SERIAL_RX_SIZE; ++i)
+        mRx[(mHead + mCount++) % SERIAL_RX_SIZE] = bytes[i];
+}
@@ -0,0 +1,101 @@
+#ifndef ARDUINO_STUB_H
+#define ARDUINO_STUB_H
+
+/*
+    Host stand-in for the Arduino core: just what the firmware uses.
+    Time is simulated (see Host.h): millis() and micros() only move when the tests or the
+    stand-in transports advance them.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// No separate flash address space on the host
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*reinterpret_cast<const uint8_t *>(p))
+#define pgm_read_word(p) (*reinterpret_cast<const uint16_t *>(p))
+#define pgm_read_dword(p) (*reinterpret_cast<const uint32_t *>(p))
+#define pgm_read_ptr(p) (*reinterpret_cast<void *const *>(p))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define A0 14
+#define SDA 18
+#define SCL 19
+
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+int analogRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+void pinMode(uint8_t pin, uint8_t mode);
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// Host only: move the simulated clock forward
+void AdvanceMicros(unsigned long us);
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t value) = 0;
+    size_t write(const uint8_t *buffer, size_t size);
+
+    size_t print(const __FlashStringHelper *text);
+    size_t print(const char *text);
+    size_t print(char value);
+    size_t print(unsigned char value, int base = 10) { return print(static_cast<unsigned long>(value), base); }
+    size_t print(int value, int base = 10) { return print(static_cast<long>(value), base); }
+    size_t print(unsigned int value, int base = 10) { return print(static_cast<unsigned long>(value), base); }
+    size_t print(long value, int base = 10);
+    size_t print(unsigned long value, int base = 10);
+};
+
+// Serial port: the tests queue the bytes read by the firmware (Receive), the bytes written are counted
+#define SERIAL_RX_SIZE 64
+
+class HardwareSerial : public Print
+{
+public:
+    HardwareSerial() : txBytes(0), mHead(0), mCount(0) {}
+    void begin(unsigned long baud) {}
+    int available() { return mCount; }
+    int read();
+    int availableForWrite() { return 64; }
+    size_t write(uint8_t value) override;
+    using Print::write;
+    explicit operator bool() const { return true; }
+
+    void Receive(const uint8_t *bytes, uint8_t length);
+
+    unsigned long txBytes;
+
+private:
+    uint8_t mRx[SERIAL_RX_SIZE];
+    uint8_t mHead, mCount;
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef EEPROM_STUB_H
+#define EEPROM_STUB_H
+
+// Host stand-in for the 1KB EEPROM of the ATmega328P, erased (0xFF) at start (defined in Arduino.cpp)
+#include "Arduino.h"
+
+#define EEPROM_SIZE 1024
+
+struct EEPROMClass
+{
+    uint8_t bytes[EEPROM_SIZE];
+
+    EEPROMClass() { memset(bytes, 0xFF, sizeof(bytes)); }
+    uint8_t read(int address) { return bytes[address]; }
+    void write(int address, uint8_t value) { bytes[address] = value; }
+    void update(int address, uint8_t value) { bytes[address] = value; }
+    uint16_t length() { return EEPROM_SIZE; }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
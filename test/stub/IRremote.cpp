@@ -0,0 +1,20 @@
+#include "IRremote.h"
+
+static unsigned long sCodes[IR_QUEUE_SIZE];
+static uint8_t sHead, sCount;
+
+void IRrecv::Receive(unsigned long code)
+{
+    if (sCount < IR_QUEUE_SIZE)
+        sCodes[(sHead + sCount++) % IR_QUEUE_SIZE] = code;
+}
+
+bool IRrecv::decode(decode_results *results)
+{
+    if (sCount == 0)
+        return false;
+    results->value = sCodes[sHead];
+    sHead = (sHead + 1) % IR_QUEUE_SIZE;
+    sCount--;
+    return true;
+}
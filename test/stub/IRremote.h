@@ -0,0 +1,26 @@
+#ifndef IRREMOTE_STUB_H
+#define IRREMOTE_STUB_H
+
+// Host stand-in for the IR receiver: it decodes the codes queued by the tests (see HostPressKey)
+#include "Arduino.h"
+
+#define IR_QUEUE_SIZE 16
+
+struct decode_results
+{
+    unsigned long value;
+};
+
+class IRrecv
+{
+public:
+    IRrecv(int pin) {}
+    void enableIRIn() {}
+    bool decode(decode_results *results);
+    void resume() {}
+
+    // Queue a code, received at the next decode()
+    static void Receive(unsigned long code);
+};
+
+#endif
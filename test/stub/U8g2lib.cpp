@@ -0,0 +1,213 @@
+#include "U8g2lib.h"
+
+// | advance | ascent |, about the size of the real fonts
+const uint8_t u8g2_font_profont22_tr[] = {11, 14};
+const uint8_t u8g2_font_BitTypeWriter_tr[] = {6, 9};
+
+uint8_t gSsd1306Ram[SSD1306_RAM_SIZE];
+uint8_t gU8g2Frame[SSD1306_RAM_SIZE];
+unsigned long gU8g2Frames;
+U8g2Pixels gU8g2Pixels;
+
+// SSD1306 I2C control bytes, and the data bytes the u8x8 driver sends per transaction
+#define SSD1306_COMMANDS 0x00
+#define SSD1306_DATA 0x40
+#define SSD1306_DATA_CHUNK 24
+
+// Bus clocks of one byte and its ACK bit, bus clock (Hz)
+#define I2C_BYTE_CLOCKS 9
+#define I2C_CLOCK 400000UL
+
+static void SendBytes(u8x8_t *u8x8, const uint8_t *bytes, uint8_t length)
+{
+    u8x8->byte_cb(u8x8, U8X8_MSG_BYTE_START_TRANSFER, 0, NULL);
+    u8x8->byte_cb(u8x8, U8X8_MSG_BYTE_SEND, length, const_cast<uint8_t *>(bytes));
+    u8x8->byte_cb(u8x8, U8X8_MSG_BYTE_END_TRANSFER, 0, NULL);
+}
+
+// SSD1306 driver: set the column and page of the tiles, then send them in chunks
+static uint8_t Ssd1306DisplayCb(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+    if (msg != U8X8_MSG_DISPLAY_DRAW_TILE)
+        return 1;
+
+    const u8x8_tile_t *tile = static_cast<const u8x8_tile_t *>(arg_ptr);
+    uint8_t x = tile->x_pos * 8;
+    const uint8_t commands[] = {SSD1306_COMMANDS, static_cast<uint8_t>(0x10 | x >> 4), static_cast<uint8_t>(x & 0x0F), static_cast<uint8_t>(0xB0 | tile->y_pos)};
+    SendBytes(u8x8, commands, sizeof(commands));
+
+    for (uint8_t repeat = 0; repeat < arg_int; ++repeat)
+    {
+        const uint16_t length = tile->cnt * 8;
+        for (uint16_t sent = 0; sent < length; sent += SSD1306_DATA_CHUNK)
+        {
+            uint8_t chunk[1 + SSD1306_DATA_CHUNK] = {SSD1306_DATA};
+            const uint8_t count = min(length - sent, SSD1306_DATA_CHUNK);
+            memcpy(chunk + 1, tile->tile_ptr + sent, count);
+            SendBytes(u8x8, chunk, 1 + count);
+        }
+        // The display RAM wraps at the end of the page
+        for (uint16_t i = 0; i < length; ++i)
+            gSsd1306Ram[tile->y_pos * 128 + (x + i) % 128] = tile->tile_ptr[i];
+        x = (x + length) % 128;
+    }
+    return 1;
+}
+
+uint8_t u8x8_byte_arduino_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+    // Bus clocks since start, and the time added to the clock for them (a byte is not a whole microsecond)
+    static unsigned long long clocks;
+    static unsigned long long added;
+    if (msg == U8X8_MSG_BYTE_SEND || msg == U8X8_MSG_BYTE_START_TRANSFER)
+    {
+        // START then the address byte, or the data bytes
+        clocks += I2C_BYTE_CLOCKS * (msg == U8X8_MSG_BYTE_SEND ? arg_int : 1);
+        const unsigned long long us = clocks * 1000000UL / I2C_CLOCK;
+        AdvanceMicros(us - added);
+        added = us;
+    }
+    return 1;
+}
+
+uint8_t u8x8_gpio_and_delay_arduino(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr) { return 1; }
+
+void u8g2_Setup_ssd1306_i2c_128x64_noname_2(u8g2_t *u8g2, const u8g2_cb_t *rotation, u8x8_msg_cb byte_cb, u8x8_msg_cb gpio_and_delay_cb)
+{
+    u8g2->u8x8.display_cb = Ssd1306DisplayCb;
+    u8g2->u8x8.byte_cb = byte_cb;
+    u8g2->u8x8.gpio_and_delay_cb = gpio_and_delay_cb;
+    u8g2->u8x8.i2c_address = 0x78;
+}
+
+void U8G2::begin()
+{
+    u8x8_t *u8x8 = &u8g2.u8x8;
+    u8x8->byte_cb(u8x8, U8X8_MSG_BYTE_INIT, 0, NULL);
+
+    // Init sequence of the SSD1306 (display off, clocks, charge pump...), then a clear display:
+    // one empty tile repeated over every tile row
+    const uint8_t init[26] = {SSD1306_COMMANDS, 0xAE};
+    SendBytes(u8x8, init, sizeof(init));
+    uint8_t empty[8] = {};
+    u8x8_tile_t tile = {empty, 1, 0, 0};
+    for (tile.y_pos = 0; tile.y_pos < 8; ++tile.y_pos)
+        u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_DRAW_TILE, 16, &tile);
+}
+
+void U8G2::firstPage()
+{
+    memset(mBuffer, 0, sizeof(mBuffer));
+    mTileRow = 0;
+}
+
+uint8_t U8G2::nextPage()
+{
+    u8x8_t *u8x8 = &u8g2.u8x8;
+    for (uint8_t row = 0; row < getBufferTileHeight(); ++row)
+    {
+        u8x8_tile_t tile = {mBuffer + row * 128, 16, 0, static_cast<uint8_t>(mTileRow + row)};
+        u8x8->display_cb(u8x8, U8X8_MSG_DISPLAY_DRAW_TILE, 1, &tile);
+    }
+    memcpy(gU8g2Frame + mTileRow * 128, mBuffer, sizeof(mBuffer));
+
+    memset(mBuffer, 0, sizeof(mBuffer));
+    mTileRow += getBufferTileHeight();
+    if (mTileRow < 8)
+        return 1;
+    gU8g2Frames++;
+    gU8g2Pixels.last = 0;
+    for (uint16_t i = 0; i < SSD1306_RAM_SIZE; ++i)
+        gU8g2Pixels.last += __builtin_popcount(gU8g2Frame[i]);
+    gU8g2Pixels.worst = max(gU8g2Pixels.worst, gU8g2Pixels.last);
+    return 0;
+}
+
+// Pixels outside the current page are clipped
+void U8G2::drawPixel(int x, int y)
+{
+    const int row = y - mTileRow * 8;
+    if (x < 0 || x >= 128 || row < 0 || row >= getBufferTileHeight() * 8)
+        return;
+    mBuffer[row / 8 * 128 + x] |= 1 << (row % 8);
+}
+
+void U8G2::drawHLine(int x, int y, int w)
+{
+    for (int i = 0; i < w; ++i)
+        drawPixel(x + i, y);
+}
+
+void U8G2::drawVLine(int x, int y, int h)
+{
+    for (int i = 0; i < h; ++i)
+        drawPixel(x, y + i);
+}
+
+void U8G2::drawBox(int x, int y, int w, int h)
+{
+    for (int i = 0; i < h; ++i)
+        drawHLine(x, y + i, w);
+}
+
+void U8G2::drawFrame(int x, int y, int w, int h)
+{
+    drawHLine(x, y, w);
+    drawHLine(x, y + h - 1, w);
+    drawVLine(x, y + 1, h - 2);
+    drawVLine(x + w - 1, y + 1, h - 2);
+}
+
+// Midpoint circle of u8g2 (u8g2_DrawCircle), all the octants
+void U8G2::drawCircle(int x0, int y0, int rad, uint8_t option)
+{
+    int f = 1 - rad;
+    int ddF_x = 1;
+    int ddF_y = -2 * rad;
+    int x = 0;
+    int y = rad;
+    for (;;)
+    {
+        drawPixel(x0 + x, y0 - y);
+        drawPixel(x0 + y, y0 - x);
+        drawPixel(x0 - x, y0 - y);
+        drawPixel(x0 - y, y0 - x);
+        drawPixel(x0 + x, y0 + y);
+        drawPixel(x0 + y, y0 + x);
+        drawPixel(x0 - x, y0 + y);
+        drawPixel(x0 - y, y0 + x);
+        if (x >= y)
+            break;
+        if (f >= 0)
+        {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+    }
+}
+
+// Stripes of the character bits, one column less than the advance (see U8g2lib.h)
+size_t U8G2::write(uint8_t value)
+{
+    if (mFont == NULL)
+        return 0;
+    const uint8_t advance = mFont[0];
+    const uint8_t ascent = mFont[1];
+    if (value != ' ')
+    {
+        for (uint8_t column = 0; column + 1 < advance; ++column)
+        {
+            for (uint8_t row = 0; row < ascent; ++row)
+            {
+                if (value >> (column + row) % 7 & 1)
+                    drawPixel(mCursorX + column, mCursorY - ascent + row);
+            }
+        }
+    }
+    mCursorX += advance;
+    return 1;
+}
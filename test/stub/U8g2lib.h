@@ -0,0 +1,132 @@
+#ifndef U8G2LIB_STUB_H
+#define U8G2LIB_STUB_H
+
+/*
+    Host stand-in for u8g2 with a SSD1306 128x64 in page mode (2 tile rows per page, like NONAME_2).
+        - Drawing rasterises into the 256 bytes page buffer, in the SSD1306 layout (one byte per
+          column of 8 rows, top row in bit 0), with the u8g2 algorithms for boxes, frames and circles.
+        - There are no fonts: a glyph is a stripe pattern of the bits of its character, as wide as
+          the font advance and as high as its ascent, so text has a stable shape in golden frames.
+        - nextPage() sends the page through the u8x8 display callback; the SSD1306 driver stand-in
+          writes the tiles in gSsd1306Ram (what the display shows) and sends the command and data
+          bytes through the u8x8 byte callback, as the u8x8 SSD1306 I2C driver does.
+        - The HW_I2C transport stand-in takes the time of the bytes on a 400kHz bus (simulated clock).
+    gU8g2Frame holds every page as it was drawn, to compare with what reached the display,
+    gU8g2Frames counts the frames completed and gU8g2Pixels the pixels set in them (the firmware
+    does not count them: it would take a pass over every page buffer).
+*/
+
+#include "Arduino.h"
+
+#define U8G2_DRAW_ALL 0x0f
+#define U8G2_R0 (static_cast<const u8g2_cb_t *>(0))
+
+#define U8X8_MSG_DISPLAY_DRAW_TILE 15
+#define U8X8_MSG_BYTE_SEND 23
+#define U8X8_MSG_BYTE_INIT 20
+#define U8X8_MSG_BYTE_START_TRANSFER 24
+#define U8X8_MSG_BYTE_END_TRANSFER 25
+
+// Fonts: | advance | ascent |
+#define U8G2_FONT_SECTION(name)
+extern const uint8_t u8g2_font_profont22_tr[];
+extern const uint8_t u8g2_font_BitTypeWriter_tr[];
+
+typedef struct u8x8_struct u8x8_t;
+typedef uint8_t (*u8x8_msg_cb)(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
+
+struct u8x8_tile_t
+{
+    uint8_t *tile_ptr;
+    uint8_t cnt;
+    uint8_t x_pos;
+    uint8_t y_pos;
+};
+
+struct u8x8_struct
+{
+    u8x8_msg_cb display_cb;
+    u8x8_msg_cb byte_cb;
+    u8x8_msg_cb gpio_and_delay_cb;
+    uint8_t i2c_address;
+};
+
+#define u8x8_GetI2CAddress(u8x8) ((u8x8)->i2c_address)
+
+typedef struct u8g2_cb_struct u8g2_cb_t;
+
+struct u8g2_t
+{
+    u8x8_t u8x8;
+};
+
+void u8g2_Setup_ssd1306_i2c_128x64_noname_2(u8g2_t *u8g2, const u8g2_cb_t *rotation, u8x8_msg_cb byte_cb, u8x8_msg_cb gpio_and_delay_cb);
+uint8_t u8x8_byte_arduino_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
+uint8_t u8x8_gpio_and_delay_arduino(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
+
+// SSD1306 RAM as received from the bus, and the frame drawn by u8g2 (128x64, SSD1306 layout)
+#define SSD1306_RAM_SIZE (128 * 64 / 8)
+extern uint8_t gSsd1306Ram[SSD1306_RAM_SIZE];
+extern uint8_t gU8g2Frame[SSD1306_RAM_SIZE];
+extern unsigned long gU8g2Frames;
+
+// Pixels set in the last frame completed, and in the worst one since the tests reset it
+struct U8g2Pixels
+{
+    uint16_t last;
+    uint16_t worst;
+};
+extern U8g2Pixels gU8g2Pixels;
+
+class U8G2 : public Print
+{
+public:
+    U8G2() : mTileRow(0), mFont(0), mCursorX(0), mCursorY(0) { memset(mBuffer, 0, sizeof(mBuffer)); }
+
+    void begin();
+    void setPowerSave(uint8_t is_enable) {}
+    void firstPage();
+    uint8_t nextPage();
+
+    void setFont(const uint8_t *font) { mFont = font; }
+    void setCursor(int x, int y)
+    {
+        mCursorX = x;
+        mCursorY = y;
+    }
+    size_t write(uint8_t value) override;
+    using Print::write;
+
+    void drawPixel(int x, int y);
+    void drawHLine(int x, int y, int w);
+    void drawVLine(int x, int y, int h);
+    void drawBox(int x, int y, int w, int h);
+    void drawFrame(int x, int y, int w, int h);
+    void drawCircle(int x0, int y0, int rad, uint8_t option = U8G2_DRAW_ALL);
+
+    uint8_t *getBufferPtr() { return mBuffer; }
+    uint8_t getBufferTileHeight() const { return 2; }
+    uint8_t getBufferTileWidth() const { return 16; }
+    uint8_t getBufferCurrTileRow() const { return mTileRow; }
+    u8x8_t *getU8x8() { return &u8g2.u8x8; }
+
+protected:
+    u8g2_t u8g2;
+
+private:
+    uint8_t mBuffer[128 * 2];
+    uint8_t mTileRow;
+    const uint8_t *mFont;
+    int mCursorX, mCursorY;
+};
+
+class U8G2_SSD1306_128X64_NONAME_2_HW_I2C : public U8G2
+{
+public:
+    U8G2_SSD1306_128X64_NONAME_2_HW_I2C(const u8g2_cb_t *rotation, uint8_t reset = 255, uint8_t clock = 255, uint8_t data = 255)
+    {
+        u8g2_Setup_ssd1306_i2c_128x64_noname_2(&u8g2, rotation, u8x8_byte_arduino_hw_i2c, u8x8_gpio_and_delay_arduino);
+    }
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef EZBUZZER_STUB_H
+#define EZBUZZER_STUB_H
+
+// Host stand-in for the buzzer: beeps are only counted
+#include "Arduino.h"
+
+#define BUZZER_IDLE 0
+
+class ezBuzzer
+{
+public:
+    ezBuzzer(int pin) : beeps(0) {}
+    void loop() {}
+    void beep(unsigned long duration) { beeps++; }
+    int getState() { return BUZZER_IDLE; }
+
+    unsigned long beeps;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#!/bin/sh
+# Build the firmware variants (games and features selected at build time, see Util.h) and report
+# the flash and static SRAM used by each one, and the difference with the full build.
+#
+# Usage: tools/build_variants.sh [build-dir] [name=flags...]
+#   build-dir      where each variant is built, in its own folder (default build-variants)
+#   name=flags     variants to build instead of the default ones, e.g. "tiny=-DGAME_PONG=0 -DFEATURE_SOUND=0"
+#
+# The flags are passed to every source (sketch and libraries) as build.extra_flags.
+# FQBN (default arduino:avr:uno), ARDUINO_CLI (default arduino-cli) and AVR_SIZE (default avr-size)
+# can be set in the environment. Run it from the sketch folder.
+#
+# Example:
+#   tools/build_variants.sh && tools/memory_report.sh build-variants/snake
+
+BUILD=${1:-build-variants}
+[ $# -gt 0 ] && shift
+FQBN=${FQBN:-arduino:avr:uno}
+CLI=${ARDUINO_CLI:-arduino-cli}
+SIZE=${AVR_SIZE:-avr-size}
+
+if [ $# -eq 0 ]; then
+    # The first variant is the reference for the differences
+    set -- \
+        "full=" \
+        "snake=-DGAME_PONG=0" \
+        "pong=-DGAME_SNAKE=0" \
+        "no-sound=-DFEATURE_SOUND=0" \
+        "no-serial=-DFEATURE_SERIAL=0" \
+        "snake-minimal=-DGAME_PONG=0 -DFEATURE_SOUND=0 -DFEATURE_SERIAL=0" \
+        "profile=-DPROFILE=1" \
+        "async-display=-DDISPLAY_ASYNC=1 -DU8X8_NO_HW_I2C"
+    # The font subsets once tools/fontsubset.py has generated them
+    [ -f FontSubset.cpp ] && set -- "$@" "font-subset=-DFONT_SUBSET=1"
+fi
+
+mkdir -p "$BUILD"
+REPORT=""
+for variant in "$@"; do
+    name=${variant%%=*}
+    flags=${variant#*=}
+    echo "building $name ($flags)" >&2
+    if ! $CLI compile -b "$FQBN" --build-path "$BUILD/$name" --build-property "build.extra_flags=$flags" . > "$BUILD/$name.log" 2>&1; then
+        echo "error: $name does not build, see $BUILD/$name.log" >&2
+        exit 1
+    fi
+    # Berkeley format: text data bss dec hex filename. Flash holds .text and the .data initializers
+    ELF=$(ls "$BUILD/$name"/*.elf | head -n 1)
+    REPORT="$REPORT$($SIZE -B "$ELF" | awk -v name="$name" 'NR == 2 { print name, $1 + $2, $2 + $3 }')
+"
+done
+
+printf '%-16s %8s %8s %8s %8s\n' "variant" "flash" "diff" "sram" "diff"
+printf '%s' "$REPORT" | awk 'NR == 1 { flash = $2; sram = $3 }
+    { printf "%-16s %8d %+8d %8d %+8d\n", $1, $2, $2 - flash, $3, $3 - sram }'
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""
+Generate u8g2 fonts reduced to the glyphs the firmware prints (see Fonts.h).
+
+The sketch sources are scanned for the text printed after every setFont(FONT_...): string literals
+given to print(), numbers (print of anything else adds the digits) and the menu titles. Then bdfconv
+(from the u8g2 repository, tools/font/bdfconv) builds one subset font per FONT_ name in
+FontSubset.cpp, and the flash used by each subset is compared with the "_tr" font it replaces.
+
+Usage:
+    fontsubset.py --list                        print the glyphs used with every font, and the share of the
+                                                "_tr" glyphs they are (no font needed)
+    fontsubset.py --bdf-dir DIR [--bdfconv EXE] generate FontSubset.cpp, then build with FONT_SUBSET=1
+
+DIR is the BDF folder of the u8g2 repository (tools/font/bdf). Only the Python standard library is needed.
+"""
+
+import argparse
+import glob
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+OUTPUT = os.path.join(ROOT, "FontSubset.cpp")
+
+# FONT_ name in Fonts.h -> (generated array name, BDF file of the original font)
+FONTS = {
+    "FONT_TITLE": ("gFontTitle", "profont22.bdf"),
+    "FONT_TEXT": ("gFontText", "BitTypeWriter.bdf"),
+}
+# Font active before the first setFont() of a file
+DEFAULT_FONT = "FONT_TEXT"
+# Glyphs of the "_tr" fonts the subsets replace (127 has no glyph)
+FULL_RANGE = "32-127"
+FULL_GLYPHS = 95
+
+SET_FONT = re.compile(r"setFont\((FONT_\w+)\)")
+PRINT = re.compile(r"print\((.*)\);")
+LITERAL = re.compile(r'"((?:[^"\\]|\\.)*)"')
+# Menu titles are stored in flash and printed later, with the text font
+TITLE = re.compile(r'_TITLE\[\]\s*PROGMEM\s*=\s*"([^"]*)"')
+
+
+def scan(sources):
+    """Returns {FONT_ name: set of characters printed with it}"""
+    glyphs = {name: set() for name in FONTS}
+    for path in sources:
+        font = DEFAULT_FONT
+        with open(path) as f:
+            for line in f:
+                for match in SET_FONT.finditer(line):
+                    font = match.group(1)
+                for match in TITLE.finditer(line):
+                    glyphs[DEFAULT_FONT].update(match.group(1))
+                for match in PRINT.finditer(line):
+                    literal = LITERAL.search(match.group(1))
+                    if literal:
+                        glyphs[font].update(bytes(literal.group(1), "utf-8").decode("unicode_escape"))
+                    else:
+                        glyphs[font].update("0123456789")
+    return glyphs
+
+
+def glyph_map(chars):
+    """bdfconv -m argument: comma separated codes and ranges"""
+    codes = sorted(ord(c) for c in chars)
+    ranges = []
+    for code in codes:
+        if ranges and ranges[-1][1] == code - 1:
+            ranges[-1][1] = code
+        else:
+            ranges.append([code, code])
+    return ",".join(str(a) if a == b else "%d-%d" % (a, b) for a, b in ranges)
+
+
+def bdfconv(exe, bdf, mapping, name, workdir):
+    """Returns the C source of the font built by bdfconv, and its size in bytes"""
+    out = os.path.join(workdir, name + ".c")
+    subprocess.run([exe, "-f", "1", "-b", "0", "-m", mapping, "-n", name, "-o", out, bdf],
+                   check=True, stdout=subprocess.DEVNULL)
+    with open(out) as f:
+        source = f.read()
+    return source, int(re.search(r"\[(\d+)\]", source).group(1))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--list", action="store_true", help="only print the glyphs used with every font")
+    parser.add_argument("--bdf-dir", help="folder of the original BDF fonts (u8g2 tools/font/bdf)")
+    parser.add_argument("--bdfconv", default="bdfconv", help="bdfconv executable")
+    args = parser.parse_args()
+
+    sources = [path for pattern in ("*.h", "*.cpp", "*.ino") for path in sorted(glob.glob(os.path.join(ROOT, pattern)))
+               if path != OUTPUT]
+    glyphs = scan(sources)
+
+    if args.list:
+        for name, chars in glyphs.items():
+            print("%-11s %3d of %d glyphs (%2d%%)  %s" % (name, len(chars), FULL_GLYPHS, 100 * len(chars) // FULL_GLYPHS,
+                                                   "".join(sorted(chars))))
+        return 0
+    if not args.bdf_dir:
+        parser.error("--bdf-dir is needed to generate the fonts")
+
+    arrays = []
+    print("%-11s %7s %9s %9s %7s" % ("font", "glyphs", "subset", FULL_RANGE, "saved"))
+    with tempfile.TemporaryDirectory() as workdir:
+        for name, (array, bdf) in FONTS.items():
+            path = os.path.join(args.bdf_dir, bdf)
+            source, size = bdfconv(args.bdfconv, path, glyph_map(glyphs[name]), array, workdir)
+            _, full_size = bdfconv(args.bdfconv, path, FULL_RANGE, array, workdir)
+            arrays.append(source.strip())
+            print("%-11s %7d %9d %9d %7d" % (name, len(glyphs[name]), size, full_size, full_size - size))
+
+    with open(OUTPUT, "w") as f:
+        f.write("// Generated by tools/fontsubset.py from the text printed by the firmware, do not edit\n")
+        f.write('#include "Fonts.h"\n\n#if FONT_SUBSET\n\n')
+        f.write("\n\n".join(arrays))
+        f.write("\n\n#endif\n")
+    print("wrote %s, build with FONT_SUBSET=1" % os.path.relpath(OUTPUT))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
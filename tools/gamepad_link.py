@@ -0,0 +1,408 @@
+#!/usr/bin/env python3
+"""
+Host side client for the GamePad binary Serial protocol (see Protocol.h).
+
+Frames are  | 0xA5 | type | length | payload | crc8 |  with crc8 (poly 0x07) over type, length and payload.
+
+Usage:
+    gamepad_link.py PORT key UP|DOWN|...|0x<code>   inject a key, like the IR remote would
+    gamepad_link.py PORT counters                   print the device counters
+    gamepad_link.py PORT display                    print display bus traffic (bytes, transactions, tiles) and,
+                                                    with DISPLAY_ASYNC, how much of it overlaps the CPU work
+    gamepad_link.py PORT duty [-t SECONDS]          measure the CPU duty cycle (time awake vs idle sleep)
+    gamepad_link.py PORT frames [--reset] [--max-draw-calls N] [--max-commands N]
+                                                    print the cost of the last and worst frames, fail if over budget
+    gamepad_link.py PORT profile                    print the CPU cycles of the instrumented functions (PROFILE=1 builds)
+    gamepad_link.py PORT latency [--reset]          print the input-to-photon latency histogram (key to frame on display)
+    gamepad_link.py PORT seed VALUE|noise           set the seed of the next game (replay), or reseed from noise
+    gamepad_link.py PORT monitor                    stream per-tick game state
+    gamepad_link.py PORT load [-n KEYS]             send KEYS keys as fast as possible and check none was lost
+
+PORT can be "fake": the client then talks to a pseudo-terminal stand-in of the device, which is
+enough to run the load test (and this client) in automation without a board attached. The stand-in
+runs no firmware: it answers the display, frame and latency reports with zeros (the firmware
+itself is measured on the host by the tests of test/, see test/LatencyTest.cpp).
+Only the Python standard library is needed.
+"""
+
+import argparse
+import os
+import re
+import select
+import struct
+import sys
+import termios
+import threading
+import time
+import tty
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def header_define(header, name):
+    """Default value of a build flag of the firmware (#define NAME value in a header of the sketch)"""
+    with open(os.path.join(ROOT, header)) as source:
+        return int(re.search(r"^#define %s (\d+)" % name, source.read(), re.M).group(1))
+
+FRAME_START = 0xA5
+FRAME_MAX_PAYLOAD = 20
+
+KEY = 0x01
+TELEMETRY = 0x02
+GET_COUNTERS = 0x03
+MIRROR = 0x04
+GET_DISPLAY = 0x05
+SEED = 0x06
+GET_DUTY_CYCLE = 0x07
+GET_FRAME_STATS = 0x08
+GET_PROFILE = 0x09
+GET_LATENCY = 0x0A
+STATE = 0x81
+COUNTERS = 0x83
+MIRROR_TILE = 0x84
+MIRROR_SYNC = 0x85
+DISPLAY_STATS = 0x86
+DUTY_CYCLE = 0x87
+FRAME_STATS = 0x88
+PROFILE_COUNTER = 0x89
+LATENCY = 0x8A
+
+# Codes of the default remote layout (REMOTE_ELEGOO, see tools/keyhash.py)
+KEYS = {
+    "UP": 0xFF906F, "DOWN": 0xFFE01F, "LEFT": 0xFF22DD, "RIGHT": 0xFFC23D, "POWER": 0xFFA25D, "VOL_UP": 0xFF629D,
+    "VOL_DOWN": 0xFFA857, "PLAY_PAUSE": 0xFF02FD, "0": 0xFF6897, "1": 0xFF30CF, "2": 0xFF18E7, "3": 0xFF7A85,
+    "4": 0xFF10EF, "5": 0xFF38C7, "6": 0xFF5AA5, "7": 0xFF42BD, "8": 0xFF4AB5, "9": 0xFF52AD, "REPEAT": 0xFFFFFFFF,
+}
+
+COUNTER_NAMES = ("ticks", "ir_keys", "serial_keys", "rx_frames", "rx_errors", "tx_dropped", "free_memory", "unused_stack",
+                 "first_frame_ms", "seed")
+COUNTERS_FORMAT = "<6H2h2H"
+DISPLAY_STAT_NAMES = ("bytes", "transactions", "tiles_sent", "tiles_skipped", "wait_us", "bus_errors")
+DISPLAY_STATS_FORMAT = "<I3HIH"
+TWI_CLOCK = 400000  # Hz, 9 clocks per byte (see AsyncTwi.h)
+FRAME_COST_NAMES = ("commands", "draw_calls")
+FRAME_STATS_FORMAT = "<2H" + "BH" * 2
+PROFILE_ZONES = ("Snake::GetNextMovementType", "SnakeGame::Draw", "Balls::Move", "PongGame::Draw", "Menu::Render")
+LATENCY_BUCKETS = 6  # bucket i: below 8 << i ms, the last one everything above
+LATENCY_FORMAT = "<2HI%dH" % LATENCY_BUCKETS
+GAME_TICK_MS = header_define("Util.h", "GAME_TICK_MS")  # a latency frame, in ms
+GAME_NAMES = {0: "menu", 1: "snake", 2: "pong"}
+STATE_NAMES = {0: "PLAYING", 1: "PAUSE", 2: "FINISHED", 3: "GO_MENU", 4: "MATCH_ENDED"}
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def encode(msg_type, payload=b""):
+    assert len(payload) <= FRAME_MAX_PAYLOAD
+    body = bytes((msg_type, len(payload))) + payload
+    return bytes((FRAME_START,)) + body + bytes((crc8(body),))
+
+
+class Decoder:
+    """Incremental frame parser, mirrors Link::Poll on the device"""
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.errors = 0
+
+    def feed(self, data):
+        self.buffer += data
+        frames = []
+        while True:
+            start = self.buffer.find(FRAME_START)
+            if start < 0:
+                self.buffer.clear()
+                return frames
+            del self.buffer[:start]
+            if len(self.buffer) < 3:
+                return frames
+            length = self.buffer[2]
+            if length > FRAME_MAX_PAYLOAD:
+                self.errors += 1
+                del self.buffer[:1]
+                continue
+            if len(self.buffer) < length + 4:
+                return frames
+            frame = bytes(self.buffer[:length + 4])
+            del self.buffer[:length + 4]
+            if crc8(frame[1:-1]) != frame[-1]:
+                self.errors += 1
+                continue
+            frames.append((frame[1], frame[3:-1]))
+
+
+def open_port(path, baud):
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    speed = getattr(termios, "B%d" % baud)
+    attrs[4] = attrs[5] = speed
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd
+
+
+class Client:
+    def __init__(self, fd):
+        self.fd = fd
+        self.decoder = Decoder()
+
+    def send(self, msg_type, payload=b""):
+        os.write(self.fd, encode(msg_type, payload))
+
+    def key(self, code):
+        self.send(KEY, struct.pack("<I", code & 0xFFFFFFFF))
+
+    def frames(self, timeout):
+        """Yield received frames until nothing arrives for `timeout` seconds"""
+        while select.select([self.fd], [], [], timeout)[0]:
+            for frame in self.decoder.feed(os.read(self.fd, 256)):
+                yield frame
+
+    def duty_cycle(self, timeout=1.0):
+        """Returns (micros, microseconds asleep, number of sleeps), all wrapping counters"""
+        self.send(GET_DUTY_CYCLE)
+        for msg_type, payload in self.frames(timeout):
+            if msg_type == DUTY_CYCLE:
+                return struct.unpack("<2IH", payload)
+        raise TimeoutError("no DUTY_CYCLE answer")
+
+    def frame_stats(self, reset=False, timeout=1.0):
+        """Returns (frames, immediate frames, last frame cost, worst frame cost)"""
+        self.send(GET_FRAME_STATS, b"\x01" if reset else b"")
+        for msg_type, payload in self.frames(timeout):
+            if msg_type == FRAME_STATS:
+                values = struct.unpack(FRAME_STATS_FORMAT, payload)
+                return values[0], values[1], dict(zip(FRAME_COST_NAMES, values[2:4])), dict(zip(FRAME_COST_NAMES, values[4:6]))
+        raise TimeoutError("no FRAME_STATS answer")
+
+    def profile(self, timeout=1.0):
+        """Returns {zone name: (calls, total cycles, worst cycles)}"""
+        self.send(GET_PROFILE)
+        zones = {}
+        for msg_type, payload in self.frames(timeout):
+            if msg_type == PROFILE_COUNTER:
+                zone, calls, cycles, worst = struct.unpack("<BH2I", payload)
+                zones[PROFILE_ZONES[zone] if zone < len(PROFILE_ZONES) else zone] = (calls, cycles, worst)
+                if len(zones) == len(PROFILE_ZONES):
+                    break
+        return zones
+
+    def latency(self, reset=False, timeout=1.0):
+        """Returns (keys, worst ms, total ms, histogram buckets)"""
+        self.send(GET_LATENCY, b"\x01" if reset else b"")
+        for msg_type, payload in self.frames(timeout):
+            if msg_type == LATENCY:
+                values = struct.unpack(LATENCY_FORMAT, payload)
+                return values[0], values[1], values[2], values[3:]
+        raise TimeoutError("no LATENCY answer")
+
+    def seed(self, value=None):
+        self.send(SEED, b"" if value is None else struct.pack("<H", value & 0xFFFF))
+
+    def counters(self, timeout=1.0):
+        self.send(GET_COUNTERS)
+        for msg_type, payload in self.frames(timeout):
+            if msg_type == COUNTERS:
+                values = struct.unpack(COUNTERS_FORMAT, payload)
+                return dict(zip(COUNTER_NAMES, values))
+        raise TimeoutError("no COUNTERS answer")
+
+    def display_stats(self, timeout=1.0):
+        self.send(GET_DISPLAY)
+        for msg_type, payload in self.frames(timeout):
+            if msg_type == DISPLAY_STATS:
+                return dict(zip(DISPLAY_STAT_NAMES, struct.unpack(DISPLAY_STATS_FORMAT, payload)))
+        raise TimeoutError("no DISPLAY_STATS answer")
+
+
+def format_state(payload):
+    game = GAME_NAMES.get(payload[0], payload[0])
+    state = STATE_NAMES.get(payload[1], payload[1])
+    if payload[0] == 1:
+        x, y, length, score, level = struct.unpack("<hhHBB", payload[2:10])
+        return "%s %s head=(%d,%d) length=%d score=%d level=%d" % (game, state, x, y, length, score, level)
+    if payload[0] == 2:
+        return "%s %s ball=(%d,%d) player_y=%d bot_y=%d score=%d-%d balls=%d" % ((game, state) + tuple(payload[2:9]))
+    return "%s %s %s" % (game, state, payload[2:].hex())
+
+
+class FakeDevice(threading.Thread):
+    """Pseudo-terminal stand-in of the device: counts keys, answers counters, streams a fake state"""
+
+    def __init__(self):
+        super().__init__(daemon=True)
+        self.master, slave = os.openpty()
+        tty.setraw(self.master)
+        self.path = os.ttyname(slave)
+        self.counters = dict.fromkeys(COUNTER_NAMES, 0)
+        self.telemetry = False
+
+    def reply(self, msg_type, payload):
+        os.write(self.master, encode(msg_type, payload))
+
+    def run(self):
+        decoder = Decoder()
+        while True:
+            ready = select.select([self.master], [], [], 0.01)[0]
+            self.counters["ticks"] += 1
+            if ready:
+                for msg_type, payload in decoder.feed(os.read(self.master, 256)):
+                    self.counters["rx_frames"] += 1
+                    if msg_type == KEY and len(payload) == 4:
+                        self.counters["serial_keys"] += 1
+                    elif msg_type == TELEMETRY and len(payload) == 1:
+                        self.telemetry = payload[0] != 0
+                    elif msg_type == SEED and len(payload) == 2:
+                        self.counters["seed"] = struct.unpack("<H", payload)[0]
+                    elif msg_type == GET_DISPLAY:
+                        self.reply(DISPLAY_STATS, struct.pack(DISPLAY_STATS_FORMAT, *([0] * len(DISPLAY_STAT_NAMES))))
+                    elif msg_type == GET_LATENCY:
+                        self.reply(LATENCY, struct.pack(LATENCY_FORMAT, *([0] * (3 + LATENCY_BUCKETS))))
+                    elif msg_type == GET_FRAME_STATS:
+                        self.reply(FRAME_STATS, struct.pack(FRAME_STATS_FORMAT, *([0] * 6)))
+                    elif msg_type == GET_DUTY_CYCLE:
+                        self.reply(DUTY_CYCLE, struct.pack("<2IH", int(time.monotonic() * 1e6) & 0xFFFFFFFF, 0, 0))
+                    elif msg_type == GET_COUNTERS:
+                        values = [self.counters[name] & 0xFFFF for name in COUNTER_NAMES]
+                        self.reply(COUNTERS, struct.pack(COUNTERS_FORMAT, *values))
+                self.counters["rx_errors"] = decoder.errors
+            if self.telemetry:
+                self.reply(STATE, bytes((0, 0, 0)))
+
+
+def run_load(client, keys):
+    before = client.counters()
+    start = time.monotonic()
+    for i in range(keys):
+        client.key(KEYS["UP"] if i % 2 else KEYS["DOWN"])
+    # Drain anything still in flight before asking the final counters
+    for _ in client.frames(0.2):
+        pass
+    after = client.counters()
+    elapsed = time.monotonic() - start
+
+    received = (after["serial_keys"] - before["serial_keys"]) & 0xFFFF
+    errors = (after["rx_errors"] - before["rx_errors"]) & 0xFFFF
+    print("sent %d keys in %.3f s (%.0f keys/s), device received %d, rx errors %d"
+          % (keys, elapsed, keys / elapsed, received, errors))
+    return received == keys and errors == 0
+
+
+def run_duty(client, seconds):
+    start_us, start_sleep_us, start_sleeps = client.duty_cycle()
+    time.sleep(seconds)
+    end_us, end_sleep_us, end_sleeps = client.duty_cycle()
+    elapsed = (end_us - start_us) & 0xFFFFFFFF
+    asleep = (end_sleep_us - start_sleep_us) & 0xFFFFFFFF
+    print("awake %.1f%% over %.2f s (%d sleeps)"
+          % (100.0 * (elapsed - asleep) / elapsed, elapsed / 1e6, (end_sleeps - start_sleeps) & 0xFFFF))
+
+
+def run_frames(client, args):
+    frames, immediate, last, worst = client.frame_stats(args.reset)
+    print("%d frames, %d did not fit the display list" % (frames, immediate))
+    print("%-12s %6s %6s %6s" % ("", "last", "worst", "budget"))
+    over = False
+    for name in FRAME_COST_NAMES:
+        budget = getattr(args, "max_" + name)
+        print("%-12s %6d %6d %6s" % (name, last[name], worst[name], "-" if budget is None else budget))
+        over |= budget is not None and worst[name] > budget
+    return not over
+
+
+def run_latency(client, reset):
+    keys, worst, total, buckets = client.latency(reset)
+    if keys == 0:
+        print("no key traced yet")
+        return
+    average = total / keys
+    print("%d keys, average %.1f ms (%.1f frames), worst %d ms (%.1f frames)"
+          % (keys, average, average / GAME_TICK_MS, worst, worst / GAME_TICK_MS))
+    for i, count in enumerate(buckets):
+        label = "< %d ms" % (8 << i) if i < LATENCY_BUCKETS - 1 else ">= %d ms" % (4 << i)
+        print("%-10s %6d %s" % (label, count, "#" * (40 * count // keys)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port", help="serial device, or 'fake' for the pseudo-terminal stand-in")
+    parser.add_argument("--baud", type=int, default=115200)
+    sub = parser.add_subparsers(dest="command", required=True)
+    key_parser = sub.add_parser("key")
+    key_parser.add_argument("name")
+    sub.add_parser("counters")
+    sub.add_parser("display")
+    duty_parser = sub.add_parser("duty")
+    duty_parser.add_argument("-t", "--seconds", type=float, default=2.0)
+    frames_parser = sub.add_parser("frames")
+    frames_parser.add_argument("--reset", action="store_true", help="reset the worst frame after reading it")
+    for name in FRAME_COST_NAMES:
+        frames_parser.add_argument("--max-" + name.replace("_", "-"), type=int, metavar="N")
+    sub.add_parser("profile")
+    latency_parser = sub.add_parser("latency")
+    latency_parser.add_argument("--reset", action="store_true", help="reset the histogram after reading it")
+    seed_parser = sub.add_parser("seed")
+    seed_parser.add_argument("value")
+    sub.add_parser("monitor")
+    load_parser = sub.add_parser("load")
+    load_parser.add_argument("-n", "--keys", type=int, default=1000)
+    args = parser.parse_args()
+
+    if args.port == "fake":
+        device = FakeDevice()
+        device.start()
+        args.port = device.path
+    client = Client(open_port(args.port, args.baud))
+
+    if args.command == "key":
+        client.key(KEYS[args.name] if args.name in KEYS else int(args.name, 0))
+    elif args.command == "counters":
+        for name, value in client.counters().items():
+            print("%-15s %d" % (name, value))
+    elif args.command == "display":
+        stats = client.display_stats()
+        for name, value in stats.items():
+            print("%-15s %d" % (name, value))
+        # Time on the bus (addresses left out) and the share of it the CPU did not wait for
+        bus_us = stats["bytes"] * 9 * 1000000 // TWI_CLOCK
+        if bus_us:
+            print("%-15s %d" % ("bus_us", bus_us))
+            print("%-15s %.1f%%" % ("overlap", 100.0 * max(0, bus_us - stats["wait_us"]) / bus_us))
+    elif args.command == "duty":
+        run_duty(client, args.seconds)
+    elif args.command == "frames":
+        return 0 if run_frames(client, args) else 1
+    elif args.command == "profile":
+        zones = client.profile()
+        if not zones:
+            print("no answer: is the firmware built with PROFILE=1?")
+            return 1
+        print("%-28s %6s %12s %10s %10s" % ("zone", "calls", "cycles", "average", "worst"))
+        for name, (calls, cycles, worst) in zones.items():
+            print("%-28s %6d %12d %10d %10d" % (name, calls, cycles, cycles // calls if calls else 0, worst))
+    elif args.command == "latency":
+        run_latency(client, args.reset)
+    elif args.command == "seed":
+        client.seed(None if args.value == "noise" else int(args.value, 0))
+    elif args.command == "monitor":
+        client.send(TELEMETRY, b"\x01")
+        try:
+            for msg_type, payload in client.frames(timeout=5.0):
+                if msg_type == STATE:
+                    print(format_state(payload))
+        finally:
+            client.send(TELEMETRY, b"\x00")
+    elif args.command == "load":
+        return 0 if run_load(client, args.keys) else 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""
+Generate KeyTables.h: the perfect hash tables mapping raw IR codes to keys (see Keys.h).
+
+For every remote layout, the 32-bit NEC code is folded to 16 bits (low ^ high) and hashed as
+    slot = (uint16_t)(folded * multiplier) >> (16 - bits)
+The smallest table (2^bits slots) and a multiplier without collisions are searched, so decoding
+a key is one multiplication and one PROGMEM read, whatever the number of keys.
+
+Usage:
+    keyhash.py              rewrite KeyTables.h
+    keyhash.py --check      fail if KeyTables.h is not up to date
+
+Only the Python standard library is needed.
+"""
+
+import argparse
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+OUTPUT = os.path.join(ROOT, "KeyTables.h")
+
+REPEAT = 0xFFFFFFFF  # NEC repeat code, sent while a key is held
+
+# Layout name (REMOTE_<name> in Keys.h) -> {raw code: Key}
+LAYOUTS = {
+    # Elegoo 21-key remote (Arduino starter kits)
+    "ELEGOO": {
+        0xFFA25D: "POWER", 0xFF629D: "VOL_UP", 0xFFA857: "VOL_DOWN", 0xFF02FD: "PLAY_PAUSE",
+        0xFF906F: "UP", 0xFFE01F: "DOWN", 0xFF22DD: "LEFT", 0xFFC23D: "RIGHT",
+        0xFF6897: "DIGIT_0", 0xFF30CF: "DIGIT_1", 0xFF18E7: "DIGIT_2", 0xFF7A85: "DIGIT_3", 0xFF10EF: "DIGIT_4",
+        0xFF38C7: "DIGIT_5", 0xFF5AA5: "DIGIT_6", 0xFF42BD: "DIGIT_7", 0xFF4AB5: "DIGIT_8", 0xFF52AD: "DIGIT_9",
+        REPEAT: "REPEAT",
+    },
+    # Keyes 17-key remote: arrows, OK, digits, * and #
+    "KEYES": {
+        0xFF629D: "UP", 0xFFA857: "DOWN", 0xFF22DD: "LEFT", 0xFFC23D: "RIGHT", 0xFF02FD: "PLAY_PAUSE",
+        0xFF42BD: "POWER", 0xFF52AD: "SOUND",
+        0xFF4AB5: "DIGIT_0", 0xFF6897: "DIGIT_1", 0xFF9867: "DIGIT_2", 0xFFB04F: "DIGIT_3", 0xFF30CF: "DIGIT_4",
+        0xFF18E7: "DIGIT_5", 0xFF7A85: "DIGIT_6", 0xFF10EF: "DIGIT_7", 0xFF38C7: "DIGIT_8", 0xFF5AA5: "DIGIT_9",
+        REPEAT: "REPEAT",
+    },
+}
+
+
+def slot(code, multiplier, bits):
+    folded = (code ^ (code >> 16)) & 0xFFFF
+    return ((folded * multiplier) & 0xFFFF) >> (16 - bits)
+
+
+def search(codes):
+    """Returns (bits, multiplier) of the smallest collision free table"""
+    bits = max(1, (len(codes) - 1).bit_length())
+    while bits <= 8:
+        for multiplier in range(1, 0x10000, 2):
+            if len({slot(code, multiplier, bits) for code in codes}) == len(codes):
+                return bits, multiplier
+        bits += 1
+    raise ValueError("no perfect hash found")
+
+
+def generate():
+    lines = ["// Generated by tools/keyhash.py, do not edit", "",
+             "#ifndef KEY_TABLES_H", "#define KEY_TABLES_H", "",
+             '#include "Keys.h"', ""]
+    for index, (name, keys) in enumerate(LAYOUTS.items()):
+        bits, multiplier = search(list(keys))
+        table = [None] * (1 << bits)
+        for code, key in keys.items():
+            table[slot(code, multiplier, bits)] = (code, key)
+        lines.append("%s REMOTE_LAYOUT == REMOTE_%s" % ("#if" if index == 0 else "#elif", name))
+        lines.append("// %d keys in %d slots" % (len(keys), len(table)))
+        lines.append("#define KEY_HASH_BITS %d" % bits)
+        lines.append("#define KEY_HASH_MULTIPLIER 0x%04X" % multiplier)
+        lines.append("static const KeyEntry KEY_TABLE[1 << KEY_HASH_BITS] PROGMEM = {")
+        for entry in table:
+            code, key = entry if entry else (0, "NONE")
+            lines.append("    {0x%08lX, Key::%s}," % (code, key))
+        lines.append("};")
+    lines += ["#else", '#error "Unknown REMOTE_LAYOUT"', "#endif", "", "#endif", ""]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--check", action="store_true", help="fail if KeyTables.h is not up to date")
+    args = parser.parse_args()
+
+    source = generate()
+    if args.check:
+        with open(OUTPUT) as f:
+            if f.read() != source:
+                print("KeyTables.h is out of date, run tools/keyhash.py", file=sys.stderr)
+                return 1
+        return 0
+    with open(OUTPUT, "w") as f:
+        f.write(source)
+    print("wrote %s" % os.path.relpath(OUTPUT))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""
+Generate LevelData.h: the Snake levels (see Level.h), packed for PROGMEM.
+
+Levels are drawn below in 8x8-pixel tiles covering the Snake world:
+    .  free tile
+    #  obstacle
+    > < v ^  free tile where the snake starts, and its starting direction
+Obstacles are stored as runs over the tiles in row order, one byte per run:
+    bit 7 = obstacle, bits 0-6 = run length - 1
+so a level costs a few bytes of flash, and the firmware decodes it in one pass.
+
+Usage:
+    levelpack.py            rewrite LevelData.h
+    levelpack.py --check    fail if LevelData.h is not up to date
+
+Only the Python standard library is needed.
+"""
+
+import argparse
+import os
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+OUTPUT = os.path.join(ROOT, "LevelData.h")
+
+# Snake world (SnakeWorld in Game.h) in tiles
+WORLD_WIDTH, WORLD_HEIGHT = 248, 124
+TILES_X, TILES_Y = (WORLD_WIDTH + 7) // 8, (WORLD_HEIGHT + 7) // 8
+# Start cell offset inside the start tile
+START_OFFSET = 2
+MAX_RUN = 128
+DIRECTIONS = {">": (1, 0), "<": (-1, 0), "v": (0, 1), "^": (0, -1)}
+
+# (name, starting speed in 4.4 fixed point like SNAKE_BASE_RATE, tiles)
+LEVELS = [
+    ("Open field", 16, """
+...............................
+.>.............................
+...............................
+...............................
+...............................
+...............................
+...............................
+...............................
+...............................
+...............................
+...............................
+...............................
+...............................
+...............................
+...............................
+...............................
+"""),
+    ("Pillars", 16, """
+...............................
+.>.............................
+...............................
+.....##.......##.......##......
+.....##.......##.......##......
+...............................
+...............................
+...............................
+...............................
+...............................
+...............................
+.....##.......##.......##......
+.....##.......##.......##......
+...............................
+...............................
+...............................
+"""),
+    ("Corridors", 20, """
+...............................
+.>.............................
+...............................
+...............................
+....#######################....
+...............................
+...............#...............
+...............#...............
+...............#...............
+...............#...............
+...............................
+....#######################....
+...............................
+...............................
+...............................
+...............................
+"""),
+]
+
+
+def pack(name, tiles):
+    """Returns (start x, start y, direction x, direction y, runs)"""
+    rows = tiles.strip().split("\n")
+    if len(rows) != TILES_Y or any(len(row) != TILES_X for row in rows):
+        raise ValueError("%s: level must be %dx%d tiles" % (name, TILES_X, TILES_Y))
+    starts = [(x, y) for y, row in enumerate(rows) for x, c in enumerate(row) if c in DIRECTIONS]
+    if len(starts) != 1:
+        raise ValueError("%s: level needs exactly one start" % name)
+    x, y = starts[0]
+    dx, dy = DIRECTIONS[rows[y][x]]
+    if rows[y + dy][x + dx] == "#":
+        raise ValueError("%s: the snake starts facing an obstacle" % name)
+
+    runs = []
+    cells = "".join(rows)
+    i = 0
+    while i < len(cells):
+        solid = cells[i] == "#"
+        length = 1
+        while i + length < len(cells) and (cells[i + length] == "#") == solid and length < MAX_RUN:
+            length += 1
+        runs.append((0x80 if solid else 0) | (length - 1))
+        i += length
+    return x * 8 + START_OFFSET, y * 8 + START_OFFSET, dx, dy, runs
+
+
+def generate():
+    lines = ["// Generated by tools/levelpack.py, do not edit", "",
+             "#ifndef LEVEL_DATA_H", "#define LEVEL_DATA_H", "",
+             '#include "Level.h"', "",
+             "#define LEVEL_TILES_X %d" % TILES_X,
+             "#define LEVEL_TILES_Y %d" % TILES_Y,
+             "#define LEVEL_COUNT %d" % len(LEVELS), ""]
+    entries = []
+    for index, (name, rate, tiles) in enumerate(LEVELS):
+        x, y, dx, dy, runs = pack(name, tiles)
+        lines.append("// %s: %d runs" % (name, len(runs)))
+        lines.append("static const uint8_t LEVEL_%d_RUNS[] PROGMEM = {%s};" % (index, ", ".join("0x%02X" % r for r in runs)))
+        entries.append("    {%d, %d, %d, %d, %d, LEVEL_%d_RUNS}, // %s" % (x, y, dx, dy, rate, index, name))
+    lines += ["", "static const Level LEVELS[LEVEL_COUNT] PROGMEM = {"] + entries + ["};", "", "#endif", ""]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--check", action="store_true", help="fail if LevelData.h is not up to date")
+    args = parser.parse_args()
+
+    source = generate()
+    if args.check:
+        with open(OUTPUT) as f:
+            if f.read() != source:
+                print("LevelData.h is out of date, run tools/levelpack.py", file=sys.stderr)
+                return 1
+        return 0
+    with open(OUTPUT, "w") as f:
+        f.write(source)
+    print("wrote %s" % os.path.relpath(OUTPUT))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
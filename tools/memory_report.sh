@@ -0,0 +1,29 @@
+#!/bin/sh
+# Build-time SRAM report: .data/.bss used by each translation unit of the sketch.
+#
+# Usage: tools/memory_report.sh <build-path> [max-ram-bytes]
+#   <build-path>   folder passed to "arduino-cli compile --build-path"
+#   max-ram-bytes  fail (exit 1) if globals use more than this (default 1536, i.e. 512 bytes left for heap and stack)
+#
+# Example:
+#   arduino-cli compile -b arduino:avr:uno --build-path build . && tools/memory_report.sh build
+
+BUILD=${1:?usage: $0 <build-path> [max-ram-bytes]}
+MAX_RAM=${2:-1536}
+SIZE=${AVR_SIZE:-avr-size}
+
+printf '%-28s %6s %6s %6s\n' "translation unit" ".data" ".bss" "total"
+for obj in "$BUILD"/sketch/*.o; do
+    # Berkeley format: text data bss dec hex filename
+    $SIZE -B "$obj" | awk -v name="$(basename "$obj" .o)" \
+        'NR == 2 { printf "%-28s %6d %6d %6d\n", name, $2, $3, $2 + $3 }'
+done
+
+ELF=$(ls "$BUILD"/*.elf | head -n 1)
+TOTAL=$($SIZE -B "$ELF" | awk 'NR == 2 { print $2 + $3 }')
+printf '%-28s %20d\n' "firmware (with libraries)" "$TOTAL"
+
+if [ "$TOTAL" -gt "$MAX_RAM" ]; then
+    echo "error: globals use $TOTAL bytes of SRAM, budget is $MAX_RAM" >&2
+    exit 1
+fi
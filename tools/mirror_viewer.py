@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""
+Host viewer for the GamePad screen mirroring (see Mirror.h), firmware built with SCREEN_MIRROR=1.
+
+Usage:
+    mirror_viewer.py PORT                  draw the mirrored screen in the terminal
+    mirror_viewer.py PORT --pbm DIR        also save every frame as DIR/frame_NNNNN.pbm
+
+Tiles are 8x8 pixels, one byte per column with the top pixel in bit 0 (SSD1306 layout).
+"""
+
+import argparse
+import os
+import sys
+
+from gamepad_link import Client, open_port, MIRROR, MIRROR_TILE, MIRROR_SYNC
+
+TILES_X, TILES_Y = 16, 8
+WIDTH, HEIGHT = TILES_X * 8, TILES_Y * 8
+TILE_RAW_FLAG = 0x80
+
+
+def decode_tile(payload):
+    """Returns (tile index, 8 column bytes)"""
+    index = payload[0] & ~TILE_RAW_FLAG
+    if payload[0] & TILE_RAW_FLAG:
+        return index, bytes(payload[1:9])
+    columns = bytearray()
+    for i in range(1, len(payload), 2):
+        columns += bytes((payload[i + 1],)) * payload[i]
+    return index, bytes(columns)
+
+
+class Screen:
+    def __init__(self):
+        self.tiles = [bytes(8)] * (TILES_X * TILES_Y)
+
+    def pixel(self, x, y):
+        return self.tiles[(y // 8) * TILES_X + x // 8][x % 8] >> (y % 8) & 1
+
+    def to_pbm(self):
+        rows = []
+        for y in range(HEIGHT):
+            row = bytearray(WIDTH // 8)
+            for x in range(WIDTH):
+                if self.pixel(x, y):
+                    row[x // 8] |= 0x80 >> (x % 8)
+            rows.append(bytes(row))
+        return b"P4\n%d %d\n" % (WIDTH, HEIGHT) + b"".join(rows)
+
+    def to_text(self):
+        # Two pixel rows per character cell
+        chars = {(0, 0): " ", (1, 0): "▀", (0, 1): "▄", (1, 1): "█"}
+        lines = []
+        for y in range(0, HEIGHT, 2):
+            lines.append("".join(chars[self.pixel(x, y), self.pixel(x, y + 1)] for x in range(WIDTH)))
+        return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--pbm", metavar="DIR", help="save frames as PBM images in DIR")
+    args = parser.parse_args()
+
+    client = Client(open_port(args.port, args.baud))
+    screen = Screen()
+    frame_bytes = 0
+    client.send(MIRROR, b"\x01")
+    try:
+        for msg_type, payload in client.frames(timeout=5.0):
+            if msg_type == MIRROR_TILE:
+                index, columns = decode_tile(payload)
+                screen.tiles[index] = columns
+                frame_bytes += len(payload) + 4
+            elif msg_type == MIRROR_SYNC:
+                frame = payload[0] | payload[1] << 8
+                sys.stdout.write("\x1b[H" + screen.to_text() + "\nframe %d: %d bytes\x1b[K\n" % (frame, frame_bytes))
+                sys.stdout.flush()
+                if args.pbm:
+                    with open(os.path.join(args.pbm, "frame_%05d.pbm" % frame), "wb") as f:
+                        f.write(screen.to_pbm())
+                frame_bytes = 0
+    except KeyboardInterrupt:
+        pass
+    finally:
+        client.send(MIRROR, b"\x00")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,332 @@
+/*
+    Runs the firmware ELF (built with PROFILE set to 1) on simavr, an ATmega328P at 16MHz, and
+    reports the exact CPU cycles of every profiling zone and of every frame.
+        - The zones are timed from GPIOR0 (see Profile.h): every write of a zone marker starts a
+          call, the write of the marker it replaced ends it. The cycles are those of the simulated
+          core, interrupts served during the call included.
+        - The display is a SSD1306 on the TWI: the address and data bytes are acknowledged and
+          counted, nothing is drawn.
+        - The IR receiver (pin 7, PD7) plays the NEC frames of the script: its output is low
+          during the carrier bursts, like a TSOP receiver.
+        - The buzzer (pin 3, PD3) is watched: beeps and their length are counted.
+    The script holds one key per line, "<ms> <NEC code in hex>" (e.g. "2500 0x00FF02FD" presses
+    PLAY/PAUSE 2.5s after reset, codes in KeyTables.h); '#' starts a comment.
+
+    Usage: gamepad_sim [-t] [-d ms] firmware.elf script
+        -d ms   simulated time (default: 2s after the last key)
+        -t      print every frame: start time (ms) and cycles
+    Build: cc -O2 -o gamepad_sim gamepad_sim.c $(pkg-config --cflags --libs simavr) -lelf
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_io.h"
+#include "sim_irq.h"
+#include "sim_cycle_timers.h"
+#include "avr_ioport.h"
+#include "avr_twi.h"
+
+#define F_CPU 16000000UL
+
+// GPIOR0 in the data space (I/O address 0x1E)
+#define GPIOR0_ADDRESS 0x3E
+// SSD1306 I2C address, with the write bit
+#define SSD1306_ADDRESS 0x78
+
+// Same order as ProfileZone (Profile.h), the marker is the zone number + 1
+static const char *ZONE_NAMES[] = {
+    "Snake::GetNextMovementType",
+    "SnakeGame::Draw",
+    "Balls::Move",
+    "PongGame::Draw",
+    "Menu::Render",
+};
+#define ZONE_COUNT (sizeof(ZONE_NAMES) / sizeof(ZONE_NAMES[0]))
+#define FRAME_ZONE 4
+
+// Zones only nest a few levels deep (a frame draws a game)
+#define MAX_DEPTH 8
+
+// NEC timings (us): leader burst and space, bit burst, spaces of a 0 and of a 1
+#define NEC_LEADER_MARK 9000
+#define NEC_LEADER_SPACE 4500
+#define NEC_BIT_MARK 560
+#define NEC_ZERO_SPACE 560
+#define NEC_ONE_SPACE 1690
+// Level changes of a frame: leader, 32 bits and the final burst
+#define NEC_EDGES (2 + 32 * 2 + 2)
+
+struct ZoneCounter
+{
+    unsigned long calls;
+    avr_cycle_count_t cycles;
+    avr_cycle_count_t worst;
+};
+
+struct ZoneCall
+{
+    uint8_t marker;
+    uint8_t previous;
+    avr_cycle_count_t start;
+};
+
+struct Edge
+{
+    avr_cycle_count_t cycle;
+    uint8_t level;
+};
+
+static struct ZoneCounter sZones[ZONE_COUNT];
+static struct ZoneCall sCalls[MAX_DEPTH];
+static uint8_t sDepth;
+static uint8_t sMarker;
+static int sTraceFrames;
+
+static struct Edge *sEdges;
+static size_t sEdgeCount;
+static size_t sNextEdge;
+static avr_irq_t *sIrPin;
+
+static unsigned long sTwiTransactions;
+static unsigned long sTwiBytes;
+static int sTwiSelected;
+
+static unsigned long sBeeps;
+static avr_cycle_count_t sBeepStart;
+static avr_cycle_count_t sBeepCycles;
+
+static double Milliseconds(avr_cycle_count_t cycles) { return cycles * 1000.0 / F_CPU; }
+
+static void EndCall(avr_t *avr)
+{
+    const struct ZoneCall *call = &sCalls[--sDepth];
+    const avr_cycle_count_t cycles = avr->cycle - call->start;
+    if (call->marker == 0 || call->marker > ZONE_COUNT)
+        return;
+    struct ZoneCounter *zone = &sZones[call->marker - 1];
+    zone->calls++;
+    zone->cycles += cycles;
+    if (cycles > zone->worst)
+        zone->worst = cycles;
+    if (sTraceFrames && call->marker - 1 == FRAME_ZONE)
+        printf("frame %lu at %.1f ms: %llu cycles\n", zone->calls, Milliseconds(call->start), (unsigned long long)cycles);
+}
+
+// A write of the previous marker ends the innermost call, any other marker starts one
+static void OnMarkerWrite(avr_t *avr, avr_io_addr_t address, uint8_t value, void *param)
+{
+    avr->data[address] = value;
+    if (value == sMarker)
+        return;
+    if (sDepth > 0 && value == sCalls[sDepth - 1].previous)
+        EndCall(avr);
+    else if (sDepth < MAX_DEPTH)
+    {
+        struct ZoneCall *call = &sCalls[sDepth++];
+        call->marker = value;
+        call->previous = sMarker;
+        call->start = avr->cycle;
+    }
+    sMarker = value;
+}
+
+// Messages of the TWI master: the display acknowledges its address and every byte written to it
+static void OnTwiMessage(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+    avr_irq_t *input = param;
+    avr_twi_msg_irq_t message;
+    message.u.v = value;
+
+    if (message.u.twi.msg & TWI_COND_STOP)
+        sTwiSelected = 0;
+    if (message.u.twi.msg & TWI_COND_START)
+    {
+        sTwiSelected = (message.u.twi.addr & 0xFE) == SSD1306_ADDRESS;
+        if (sTwiSelected)
+        {
+            sTwiTransactions++;
+            avr_raise_irq(input, avr_twi_irq_msg(TWI_COND_ACK, message.u.twi.addr, 1));
+        }
+    }
+    if (sTwiSelected && (message.u.twi.msg & TWI_COND_WRITE))
+    {
+        sTwiBytes++;
+        avr_raise_irq(input, avr_twi_irq_msg(TWI_COND_ACK, message.u.twi.addr, 1));
+    }
+}
+
+static void OnBuzzerPin(struct avr_irq_t *irq, uint32_t value, void *param)
+{
+    avr_t *avr = param;
+    if (value)
+    {
+        sBeeps++;
+        sBeepStart = avr->cycle;
+    }
+    else if (sBeepStart)
+    {
+        sBeepCycles += avr->cycle - sBeepStart;
+        sBeepStart = 0;
+    }
+}
+
+static avr_cycle_count_t OnIrEdge(avr_t *avr, avr_cycle_count_t when, void *param)
+{
+    while (sNextEdge < sEdgeCount && sEdges[sNextEdge].cycle <= when)
+    {
+        avr_raise_irq(sIrPin, sEdges[sNextEdge].level);
+        sNextEdge++;
+    }
+    return sNextEdge < sEdgeCount ? sEdges[sNextEdge].cycle : 0;
+}
+
+static void AddEdge(avr_cycle_count_t *cycle, uint8_t level, unsigned long us)
+{
+    sEdges[sEdgeCount].cycle = *cycle;
+    sEdges[sEdgeCount].level = level;
+    sEdgeCount++;
+    *cycle += us * (F_CPU / 1000000);
+}
+
+// The receiver output of a NEC frame: low during the bursts, high in the spaces, MSB first
+static void AddKey(unsigned long ms, uint32_t code)
+{
+    avr_cycle_count_t cycle = ms * (F_CPU / 1000);
+    AddEdge(&cycle, 0, NEC_LEADER_MARK);
+    AddEdge(&cycle, 1, NEC_LEADER_SPACE);
+    for (int bit = 31; bit >= 0; --bit)
+    {
+        AddEdge(&cycle, 0, NEC_BIT_MARK);
+        AddEdge(&cycle, 1, code >> bit & 1 ? NEC_ONE_SPACE : NEC_ZERO_SPACE);
+    }
+    AddEdge(&cycle, 0, NEC_BIT_MARK);
+    AddEdge(&cycle, 1, 0);
+}
+
+// Returns the time of the last key (ms)
+static unsigned long ReadScript(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        perror(path);
+        exit(1);
+    }
+    char line[256];
+    size_t capacity = 0;
+    unsigned long last = 0;
+    unsigned int number = 0;
+    while (fgets(line, sizeof(line), file))
+    {
+        number++;
+        char *comment = strchr(line, '#');
+        if (comment)
+            *comment = '\0';
+        unsigned long ms, code;
+        char extra;
+        const int fields = sscanf(line, "%lu %lx %c", &ms, &code, &extra);
+        if (fields <= 0)
+            continue;
+        if (fields != 2 || ms < last)
+        {
+            fprintf(stderr, "%s:%u: expected \"<ms> <code>\" in time order\n", path, number);
+            exit(1);
+        }
+        if (sEdgeCount + NEC_EDGES > capacity)
+        {
+            capacity = capacity ? capacity * 2 : 64 * NEC_EDGES;
+            sEdges = realloc(sEdges, capacity * sizeof(*sEdges));
+        }
+        AddKey(ms, (uint32_t)code);
+        last = ms;
+    }
+    fclose(file);
+    return last;
+}
+
+static void Report(avr_t *avr)
+{
+    printf("%.1f ms simulated\n", Milliseconds(avr->cycle));
+    printf("%-28s %8s %14s %10s %10s\n", "zone", "calls", "cycles", "average", "worst");
+    for (size_t i = 0; i < ZONE_COUNT; ++i)
+    {
+        const struct ZoneCounter *zone = &sZones[i];
+        printf("%-28s %8lu %14llu %10llu %10llu\n", ZONE_NAMES[i], zone->calls, (unsigned long long)zone->cycles,
+               (unsigned long long)(zone->calls ? zone->cycles / zone->calls : 0), (unsigned long long)zone->worst);
+    }
+    printf("display: %lu transactions, %lu bytes\n", sTwiTransactions, sTwiBytes);
+    printf("buzzer: %lu beeps, %.1f ms on\n", sBeeps, Milliseconds(sBeepCycles));
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long durationMs = 0;
+    int option;
+    while ((option = getopt(argc, argv, "td:")) != -1)
+    {
+        if (option == 't')
+            sTraceFrames = 1;
+        else if (option == 'd')
+            durationMs = strtoul(optarg, NULL, 0);
+        else
+            return 2;
+    }
+    if (argc - optind != 2)
+    {
+        fprintf(stderr, "usage: %s [-t] [-d ms] firmware.elf script\n", argv[0]);
+        return 2;
+    }
+
+    elf_firmware_t firmware;
+    memset(&firmware, 0, sizeof(firmware));
+    if (elf_read_firmware(argv[optind], &firmware) != 0)
+    {
+        fprintf(stderr, "%s: cannot read the firmware\n", argv[optind]);
+        return 1;
+    }
+    strcpy(firmware.mmcu, "atmega328p");
+    firmware.frequency = F_CPU;
+    const unsigned long lastKeyMs = ReadScript(argv[optind + 1]);
+    if (durationMs == 0)
+        durationMs = lastKeyMs + 2000;
+
+    avr_t *avr = avr_make_mcu_by_name(firmware.mmcu);
+    if (!avr)
+    {
+        fprintf(stderr, "simavr has no %s\n", firmware.mmcu);
+        return 1;
+    }
+    avr_init(avr);
+    avr_load_firmware(avr, &firmware);
+
+    avr_register_io_write(avr, GPIOR0_ADDRESS, OnMarkerWrite, NULL);
+
+    avr_irq_t *twiInput = avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT);
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT), OnTwiMessage, twiInput);
+
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('D'), 3), OnBuzzerPin, avr);
+
+    // The receiver output idles high
+    sIrPin = avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('D'), 7);
+    avr_raise_irq(sIrPin, 1);
+    if (sEdgeCount > 0)
+        avr_cycle_timer_register(avr, sEdges[0].cycle, OnIrEdge, NULL);
+
+    const avr_cycle_count_t end = durationMs * (F_CPU / 1000);
+    int state = cpu_Running;
+    while (avr->cycle < end && state != cpu_Done && state != cpu_Crashed)
+        state = avr_run(avr);
+
+    Report(avr);
+    if (state == cpu_Crashed)
+    {
+        fprintf(stderr, "the firmware crashed at %.1f ms\n", Milliseconds(avr->cycle));
+        return 1;
+    }
+    return 0;
+}
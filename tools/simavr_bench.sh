@@ -0,0 +1,38 @@
+#!/bin/sh
+# Cycle counts of the firmware on a simulated ATmega328P: builds it with PROFILE set to 1, builds
+# the simavr harness (tools/simavr/gamepad_sim.c) and runs the scripted session, then prints the
+# cycles of every profiling zone (Profile.h) and of every frame.
+#
+# Usage: tools/simavr_bench.sh [build-dir] [script] [gamepad_sim options...]
+#   build-dir      where the firmware and the harness are built (default build-simavr)
+#   script         keys to press (default tools/simavr/session.txt)
+#   options        e.g. -t to print every frame, -d MS to simulate MS milliseconds
+#
+# Needs arduino-cli and simavr (headers and library, e.g. the libsimavr-dev package); FQBN
+# (default arduino:avr:uno), ARDUINO_CLI (default arduino-cli), CC (default cc) and SIMAVR_FLAGS
+# (default from pkg-config) can be set in the environment. Run it from the sketch folder.
+
+BUILD=${1:-build-simavr}
+[ $# -gt 0 ] && shift
+SCRIPT=${1:-tools/simavr/session.txt}
+[ $# -gt 0 ] && shift
+FQBN=${FQBN:-arduino:avr:uno}
+CLI=${ARDUINO_CLI:-arduino-cli}
+CC=${CC:-cc}
+SIMAVR_FLAGS=${SIMAVR_FLAGS:-$(pkg-config --cflags --libs simavr 2>/dev/null || echo "-I/usr/include/simavr -lsimavr")}
+
+mkdir -p "$BUILD"
+echo "building the firmware (-DPROFILE=1)" >&2
+if ! $CLI compile -b "$FQBN" --build-path "$BUILD/firmware" --build-property "build.extra_flags=-DPROFILE=1" . > "$BUILD/firmware.log" 2>&1; then
+    echo "error: the firmware does not build, see $BUILD/firmware.log" >&2
+    exit 1
+fi
+ELF=$(ls "$BUILD/firmware"/*.elf | head -n 1)
+
+echo "building the harness" >&2
+if ! $CC -O2 -o "$BUILD/gamepad_sim" tools/simavr/gamepad_sim.c $SIMAVR_FLAGS -lelf; then
+    echo "error: the harness does not build (simavr installed? see SIMAVR_FLAGS)" >&2
+    exit 1
+fi
+
+exec "$BUILD/gamepad_sim" "$@" "$ELF" "$SCRIPT"